@@ -0,0 +1,119 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Leitura e escrita dos arquivos binarios (replays e snapshots):
+// inteiros sempre em little-endian e floats pelos seus bits,
+// qualquer que seja a maquina
+
+inline void PutU32(unsigned char* p, uint32_t v)
+{
+	for (int i = 0; i < 4; i++) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+inline void PutU64(unsigned char* p, uint64_t v)
+{
+	for (int i = 0; i < 8; i++) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+inline uint32_t GetU32(const unsigned char* p)
+{
+	uint32_t v = 0;
+	for (int i = 0; i < 4; i++) v |= static_cast<uint32_t>(p[i]) << (8 * i);
+	return v;
+}
+
+inline uint64_t GetU64(const unsigned char* p)
+{
+	uint64_t v = 0;
+	for (int i = 0; i < 8; i++) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+	return v;
+}
+
+inline uint32_t FloatBits(float f)
+{
+	uint32_t v;
+	memcpy(&v, &f, sizeof(v));
+	return v;
+}
+
+inline float BitsFloat(uint32_t v)
+{
+	float f;
+	memcpy(&f, &v, sizeof(f));
+	return f;
+}
+
+// Acrescenta valores no fim de um buffer
+class ByteWriter
+{
+public:
+	explicit ByteWriter(std::vector<unsigned char>& buffer): out(buffer) {}
+
+	void U8(unsigned char v) { out.push_back(v); }
+	void U32(uint32_t v) { size_t n = Grow(4); PutU32(&out[n], v); }
+	void U64(uint64_t v) { size_t n = Grow(8); PutU64(&out[n], v); }
+	void I32(int v) { U32(static_cast<uint32_t>(v)); }
+	void F32(float v) { U32(FloatBits(v)); }
+	void Bytes(const void* data, size_t size)
+	{
+		size_t n = Grow(size);
+		if (size > 0) memcpy(&out[n], data, size);
+	}
+
+private:
+	size_t Grow(size_t size)
+	{
+		size_t n = out.size();
+		out.resize(n + size);
+		return n;
+	}
+
+	std::vector<unsigned char>& out;
+};
+
+// Le valores em sequencia; passar do fim zera os valores e
+// deixa Ok() falso, para o chamador testar uma vez so no final
+class ByteReader
+{
+public:
+	ByteReader(const unsigned char* data, size_t size): p(data), end(data + size), ok(true) {}
+
+	unsigned char U8() { return Take(1) ? p[-1] : 0; }
+	uint32_t U32() { return Take(4) ? GetU32(p - 4) : 0; }
+	uint64_t U64() { return Take(8) ? GetU64(p - 8) : 0; }
+	int I32() { return static_cast<int>(U32()); }
+	float F32() { return BitsFloat(U32()); }
+	void Bytes(void* data, size_t size)
+	{
+		if (Take(size) && size > 0) memcpy(data, p - size, size);
+	}
+
+	// quantos bytes ainda faltam (para validar contagens antes de alocar)
+	size_t Remaining() const { return static_cast<size_t>(end - p); }
+	bool Ok() const { return ok; }
+
+private:
+	bool Take(size_t size)
+	{
+		if (!ok || Remaining() < size) {
+			ok = false;
+			return false;
+		}
+		p += size;
+		return true;
+	}
+
+	const unsigned char* p;
+	const unsigned char* end;
+	bool ok;
+};
@@ -0,0 +1,218 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "Collide.h"
+#include <cfloat>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLLIDE_SSE2 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// com GCC/Clang as funcoes AVX sao compiladas so para si mesmas,
+// o resto do programa continua valendo para qualquer CPU x86
+#if defined(COLLIDE_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define COLLIDE_TARGET_AVX __attribute__((target("avx")))
+#else
+#define COLLIDE_TARGET_AVX
+#endif
+
+// folga no fim dos vetores: o kernel de 8 caixas pode ler alem da ultima
+const size_t box_padding = 8;
+
+void BoxArrays::Resize(size_t n)
+{
+	count = n;
+	minX.assign(n + box_padding, FLT_MAX);
+	minY.assign(n + box_padding, FLT_MAX);
+	maxX.assign(n + box_padding, -FLT_MAX);
+	maxY.assign(n + box_padding, -FLT_MAX);
+}
+
+void BoxArrays::Clear(size_t i)
+{
+	minX[i] = FLT_MAX; minY[i] = FLT_MAX;
+	maxX[i] = -FLT_MAX; maxY[i] = -FLT_MAX;
+}
+
+// intervalo [entry, exit] em que [a, a + size] andando com velocidade v
+// sobrepoe [lo, hi] num eixo
+static bool SweepAxis(float a, float size, float v, float lo, float hi,
+	float& entry, float& exit)
+{
+	if (v > 0.0f)
+	{
+		entry = (lo - (a + size)) / v;
+		exit = (hi - a) / v;
+	}
+	else if (v < 0.0f)
+	{
+		entry = (hi - a) / v;
+		exit = (lo - (a + size)) / v;
+	}
+	else
+	{
+		// parado neste eixo: ou sobrepoe sempre, ou nunca
+		if (!(a < hi && lo < a + size)) return false;
+		entry = -FLT_MAX;
+		exit = FLT_MAX;
+	}
+	return true;
+}
+
+bool SweepBox(float x, float y, float w, float h, float vx, float vy,
+	float x0, float y0, float x1, float y1, float maxTime,
+	float& time, bool& hitX)
+{
+	float entryX, exitX, entryY, exitY;
+	if (!SweepAxis(x, w, vx, x0, x1, entryX, exitX)) return false;
+	if (!SweepAxis(y, h, vy, y0, y1, entryY, exitY)) return false;
+
+	float entry = entryX > entryY ? entryX : entryY;
+	float exit = exitX < exitY ? exitX : exitY;
+
+	if (entry >= exit || entry < 0.0f || entry > maxTime) return false;
+
+	time = entry;
+	hitX = entryX > entryY;
+	return true;
+}
+
+static unsigned OverlapMaskScalar(float x, float y, float w, float h,
+	const BoxArrays& boxes, size_t first, int n)
+{
+	float right = x + w;
+	float bottom = y + h;
+	unsigned mask = 0;
+	for (int i = 0; i < n; i++)
+	{
+		size_t k = first + i;
+		if (x < boxes.maxX[k] && boxes.minX[k] < right
+			&& y < boxes.maxY[k] && boxes.minY[k] < bottom)
+		{
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+}
+
+#ifdef COLLIDE_SSE2
+
+static unsigned OverlapMaskSSE2(float x, float y, float w, float h,
+	const BoxArrays& boxes, size_t first, int n)
+{
+	__m128 bx0 = _mm_set1_ps(x);
+	__m128 by0 = _mm_set1_ps(y);
+	__m128 bx1 = _mm_set1_ps(x + w);
+	__m128 by1 = _mm_set1_ps(y + h);
+
+	unsigned mask = 0;
+	for (int i = 0; i < n; i += 4)
+	{
+		size_t k = first + i;
+		__m128 hit = _mm_and_ps(
+			_mm_and_ps(_mm_cmplt_ps(bx0, _mm_loadu_ps(&boxes.maxX[k])),
+			           _mm_cmplt_ps(_mm_loadu_ps(&boxes.minX[k]), bx1)),
+			_mm_and_ps(_mm_cmplt_ps(by0, _mm_loadu_ps(&boxes.maxY[k])),
+			           _mm_cmplt_ps(_mm_loadu_ps(&boxes.minY[k]), by1)));
+		mask |= static_cast<unsigned>(_mm_movemask_ps(hit)) << i;
+	}
+	return mask & ((1u << n) - 1);
+}
+
+COLLIDE_TARGET_AVX
+static unsigned OverlapMaskAVX(float x, float y, float w, float h,
+	const BoxArrays& boxes, size_t first, int n)
+{
+	__m256 bx0 = _mm256_set1_ps(x);
+	__m256 by0 = _mm256_set1_ps(y);
+	__m256 bx1 = _mm256_set1_ps(x + w);
+	__m256 by1 = _mm256_set1_ps(y + h);
+
+	__m256 hit = _mm256_and_ps(
+		_mm256_and_ps(_mm256_cmp_ps(bx0, _mm256_loadu_ps(&boxes.maxX[first]), _CMP_LT_OQ),
+		              _mm256_cmp_ps(_mm256_loadu_ps(&boxes.minX[first]), bx1, _CMP_LT_OQ)),
+		_mm256_and_ps(_mm256_cmp_ps(by0, _mm256_loadu_ps(&boxes.maxY[first]), _CMP_LT_OQ),
+		              _mm256_cmp_ps(_mm256_loadu_ps(&boxes.minY[first]), by1, _CMP_LT_OQ)));
+	unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(hit));
+	return mask & ((1u << n) - 1);
+}
+
+static bool CpuHasAVX()
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	// AVX e o sistema salvando os registradores YMM (OSXSAVE)
+	bool avx = (info[2] & (1 << 28)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	return avx && osxsave && (_xgetbv(0) & 6) == 6;
+#else
+	return __builtin_cpu_supports("avx") != 0;
+#endif
+}
+
+#endif
+
+typedef unsigned (*OverlapFunc)(float, float, float, float, const BoxArrays&, size_t, int);
+
+static CollideKernel BestKernel()
+{
+#ifdef COLLIDE_SSE2
+	return CpuHasAVX() ? KERNEL_AVX : KERNEL_SSE2;
+#else
+	return KERNEL_SCALAR;
+#endif
+}
+
+static OverlapFunc KernelFunc(CollideKernel kernel)
+{
+	switch (kernel)
+	{
+#ifdef COLLIDE_SSE2
+		case KERNEL_AVX: return OverlapMaskAVX;
+		case KERNEL_SSE2: return OverlapMaskSSE2;
+#endif
+		default: return OverlapMaskScalar;
+	}
+}
+
+static CollideKernel currentKernel = BestKernel();
+static OverlapFunc currentFunc = KernelFunc(currentKernel);
+
+unsigned OverlapMask(float x, float y, float w, float h,
+	const BoxArrays& boxes, size_t first, int n)
+{
+	return currentFunc(x, y, w, h, boxes, first, n);
+}
+
+CollideKernel GetCollideKernel()
+{
+	return currentKernel;
+}
+
+bool SetCollideKernel(CollideKernel kernel)
+{
+	if (kernel > BestKernel()) return false;
+	currentKernel = kernel;
+	currentFunc = KernelFunc(kernel);
+	return true;
+}
+
+const char* CollideKernelName(CollideKernel kernel)
+{
+	switch (kernel)
+	{
+		case KERNEL_AVX: return "AVX";
+		case KERNEL_SSE2: return "SSE2";
+		default: return "escalar";
+	}
+}
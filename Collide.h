@@ -0,0 +1,104 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+// Teste de sobreposicao AABB de uma bola contra varias caixas de uma vez
+// (SSE2 com 4 caixas, AVX com 8), escolhido em tempo de execucao.
+
+// Alocador com alinhamento fixo, para os vetores de caixas
+template <typename T, size_t Align = 32>
+struct AlignedAllocator
+{
+	typedef T value_type;
+	template <typename U> struct rebind { typedef AlignedAllocator<U, Align> other; };
+
+	AlignedAllocator() {}
+	template <typename U> AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+	T* allocate(size_t n)
+	{
+		// guarda o ponteiro original logo antes do bloco alinhado
+		void* raw = malloc(n * sizeof(T) + Align + sizeof(void*));
+		if (!raw) throw std::bad_alloc();
+		uintptr_t start = reinterpret_cast<uintptr_t>(raw) + sizeof(void*);
+		uintptr_t aligned = (start + Align - 1) & ~(uintptr_t)(Align - 1);
+		reinterpret_cast<void**>(aligned)[-1] = raw;
+		return reinterpret_cast<T*>(aligned);
+	}
+
+	void deallocate(T* p, size_t)
+	{
+		if (p) free(reinterpret_cast<void**>(p)[-1]);
+	}
+
+	template <typename U> bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+	template <typename U> bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+};
+
+typedef std::vector<float, AlignedAllocator<float>> AlignedFloats;
+
+// Caixas (x0, y0) - (x1, y1) como estrutura de vetores alinhados.
+// Os vetores tem folga de 8 caixas vazias no fim, para que o kernel
+// possa sempre ler 8 caixas seguidas.
+class BoxArrays {
+public:
+	AlignedFloats minX;
+	AlignedFloats minY;
+	AlignedFloats maxX;
+	AlignedFloats maxY;
+
+	BoxArrays(): count(0) {}
+
+	size_t Size() const { return count; }
+
+	// n caixas, todas vazias
+	void Resize(size_t n);
+	void Set(size_t i, float x, float y, float w, float h)
+	{
+		minX[i] = x; minY[i] = y;
+		maxX[i] = x + w; maxY[i] = y + h;
+	}
+	// caixa vazia: nunca colide com nada
+	void Clear(size_t i);
+
+private:
+	size_t count;
+};
+
+// Colisao continua: a caixa (x, y, w, h) andando com velocidade (vx, vy)
+// encosta na caixa (x0, y0) - (x1, y1) em algum instante de [0, maxTime]?
+// Em caso afirmativo devolve o instante em time e, em hitX, se a entrada
+// foi por uma face vertical (esquerda/direita) da caixa. Caixas que ja
+// se sobrepoem em t = 0 nao contam.
+bool SweepBox(float x, float y, float w, float h, float vx, float vy,
+	float x0, float y0, float x1, float y1, float maxTime,
+	float& time, bool& hitX);
+
+enum CollideKernel
+{
+	KERNEL_SCALAR,
+	KERNEL_SSE2,
+	KERNEL_AVX
+};
+
+// Bits i (0..n-1) ligados para cada caixa first+i que sobrepoe a bola
+// (x, y, w, h); n vai ate 8. Mesmo criterio de Ball::collide.
+unsigned OverlapMask(float x, float y, float w, float h,
+	const BoxArrays& boxes, size_t first, int n);
+
+// Kernel em uso; comeca com o melhor que a CPU suporta
+CollideKernel GetCollideKernel();
+// Troca o kernel (para comparacoes); retorna false se a CPU nao suporta
+bool SetCollideKernel(CollideKernel kernel);
+const char* CollideKernelName(CollideKernel kernel);
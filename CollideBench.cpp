@@ -0,0 +1,92 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+// Microbenchmark: Ball::collide (escalar, bloco a bloco) contra os
+// kernels em lote de Collide.h, num tabuleiro denso de blocos.
+
+#include "CollideBench.h"
+#include "Simulation.h"
+#include <chrono>
+#include <cstdio>
+
+// uma bola passeando por todo o tabuleiro, sempre nas mesmas posicoes
+static void BallPositions(std::vector<Vector2>& out, size_t count)
+{
+	out.resize(count);
+	unsigned seed = 12345;
+	for (auto& p : out) {
+		seed = seed * 1664525u + 1013904223u;
+		p.x = thickness + (seed >> 8) % (SCREEN_WIDTH - 3 * thickness);
+		seed = seed * 1664525u + 1013904223u;
+		p.y = thickness + (seed >> 8) % (SCREEN_HEIGHT / 3);
+	}
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int RunCollideBench(int columns, int rows, long queries)
+{
+	SimConfig config;
+	config.columns = columns;
+	config.rows = rows;
+
+	Simulation sim;
+	sim.Initialize(config);
+
+	std::vector<Vector2> positions;
+	BallPositions(positions, 4096);
+
+	const size_t blocks = sim.vBlock.size();
+	printf("tabuleiro: %dx%d (%zu blocos), %ld consultas\n", columns, rows, blocks, queries);
+
+	// escalar: cada bola contra cada bloco, com Ball::collide
+	long scalarHits = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (long q = 0; q < queries; q++) {
+		const Vector2& p = positions[q % positions.size()];
+		Ball b(p.x, p.y, 0.0f, 0.0f, thickness, thickness);
+		for (auto const& block : sim.vBlock) {
+			if (block.onScreen && b.collide(block.pos, block.width, block.height)) scalarHits++;
+		}
+	}
+	double scalarTime = Seconds(start);
+	printf("%-8s %10.3f ms  %12.1f Mcaixas/s  acertos %ld\n", "collide",
+		scalarTime * 1000.0, queries * (double)blocks / scalarTime / 1e6, scalarHits);
+
+	// kernels em lote, 8 caixas por chamada
+	CollideKernel original = GetCollideKernel();
+	const CollideKernel kernels[] = { KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX };
+	int result = 0;
+	for (CollideKernel kernel : kernels) {
+		if (!SetCollideKernel(kernel)) continue;
+
+		long hits = 0;
+		start = std::chrono::steady_clock::now();
+		for (long q = 0; q < queries; q++) {
+			const Vector2& p = positions[q % positions.size()];
+			for (size_t first = 0; first < blocks; first += 8) {
+				int n = blocks - first < 8 ? (int)(blocks - first) : 8;
+				unsigned mask = OverlapMask(p.x, p.y, thickness, thickness, sim.blockBoxes, first, n);
+				for (; mask; mask &= mask - 1) hits++;
+			}
+		}
+		double time = Seconds(start);
+		printf("%-8s %10.3f ms  %12.1f Mcaixas/s  acertos %ld  (%.1fx)\n", CollideKernelName(kernel),
+			time * 1000.0, queries * (double)blocks / time / 1e6, hits, scalarTime / time);
+
+		// todos os kernels precisam concordar com Ball::collide
+		if (hits != scalarHits) result = 1;
+	}
+	SetCollideKernel(original);
+
+	if (result != 0) printf("ERRO: kernels discordam de Ball::collide\n");
+	return result;
+}
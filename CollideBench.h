@@ -0,0 +1,13 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+
+// Compara Ball::collide com os kernels de Collide.h num tabuleiro
+// columns x rows; retorna 0 se todos encontraram as mesmas colisoes
+int RunCollideBench(int columns, int rows, long queries);
@@ -0,0 +1,264 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+// Modo por eventos: em vez de testar todas as bolas a cada tick,
+// calcula o instante exato da proxima colisao de cada bola (paredes,
+// raquetes e blocos do mapa), guarda esses instantes num heap e so
+// processa os eventos que vencem. Entre colisoes as bolas andam em
+// linha reta, entao a simulacao pula direto de uma colisao para a outra.
+
+#include "Simulation.h"
+#include <cfloat>
+#include <functional>
+#include <queue>
+
+enum EventKind
+{
+	EVENT_NONE,
+	EVENT_WALL_X,
+	EVENT_WALL_TOP,
+	EVENT_WALL_BOTTOM,
+	EVENT_PADDLE,
+	EVENT_BLOCK_X,
+	EVENT_BLOCK_Y
+};
+
+struct BallEvent
+{
+	double time;
+	unsigned ball;
+	// evento so vale se a bola nao mudou de trajetoria desde que ele
+	// foi calculado
+	unsigned version;
+	int kind;
+	// indice do bloco (em vBlock) ou da raquete
+	int target;
+
+	// empates sao resolvidos pelo indice da bola, para o resultado
+	// nao depender da ordem interna do heap
+	bool operator>(const BallEvent& o) const
+	{
+		return time > o.time || (time == o.time && ball > o.ball);
+	}
+};
+
+class EventScheduler
+{
+public:
+	EventScheduler(Simulation& simulation, double seconds)
+		:sim(simulation), balls(simulation.vBall), end(seconds)
+	{
+		ballTime.assign(balls.Size(), 0.0);
+		version.assign(balls.Size(), 0);
+	}
+
+	void Run()
+	{
+		for (unsigned i = 0; i < balls.Size(); i++) Push(i);
+
+		while (!queue.empty() && queue.top().time <= end) {
+			BallEvent ev = queue.top();
+			queue.pop();
+
+			if (ev.version != version[ev.ball]) continue;
+			if ((ev.kind == EVENT_BLOCK_X || ev.kind == EVENT_BLOCK_Y)
+				&& !sim.vBlock[ev.target].onScreen) {
+				// o bloco foi destruido por outra bola: recalcula
+				version[ev.ball]++;
+				Push(ev.ball);
+				continue;
+			}
+
+			MoveTo(ev.ball, ev.time);
+			Apply(ev);
+		}
+
+		// leva todas as bolas ate o fim do intervalo
+		for (unsigned i = 0; i < balls.Size(); i++) {
+			if (balls.alive[i]) MoveTo(i, end);
+		}
+	}
+
+private:
+	void MoveTo(unsigned i, double t)
+	{
+		float dt = static_cast<float>(t - ballTime[i]);
+		balls.posX[i] += balls.velX[i] * dt;
+		balls.posY[i] += balls.velY[i] * dt;
+		ballTime[i] = t;
+	}
+
+	// calcula o proximo evento da bola i a partir de ballTime[i]
+	void Push(unsigned i)
+	{
+		float x = balls.posX[i];
+		float y = balls.posY[i];
+		float vx = balls.velX[i];
+		float vy = balls.velY[i];
+		const float s = thickness;
+
+		float horizon = static_cast<float>(end - ballTime[i]);
+		float best = horizon;
+		int kind = EVENT_NONE;
+		int target = -1;
+
+		// paredes (mesmos limites do Step)
+		if (vx < 0.0f) {
+			float t = fmaxf((thickness - x) / vx, 0.0f);
+			if (t < best) { best = t; kind = EVENT_WALL_X; }
+		}
+		else if (vx > 0.0f) {
+			float t = fmaxf((SCREEN_WIDTH - thickness - (x + s)) / vx, 0.0f);
+			if (t < best) { best = t; kind = EVENT_WALL_X; }
+		}
+		if (vy < 0.0f) {
+			float t = fmaxf((thickness - y) / vy, 0.0f);
+			if (t < best) { best = t; kind = EVENT_WALL_TOP; }
+		}
+		else if (vy > 0.0f) {
+			float t = fmaxf((SCREEN_HEIGHT - (y + s)) / vy, 0.0f);
+			if (t < best) { best = t; kind = EVENT_WALL_BOTTOM; }
+		}
+
+		// raquetes (so quando a bola esta descendo)
+		if (vy > 0.0f) {
+			for (size_t p = 0; p < sim.vPaddle.size(); p++) {
+				const Paddle& paddle = sim.vPaddle[p];
+				float t;
+				bool hitX;
+				if (paddle.onScreen && SweepBox(x, y, s, s, vx, vy,
+					paddle.pos.x, paddle.pos.y,
+					paddle.pos.x + paddle.width, paddle.pos.y + paddle.height,
+					best, t, hitX) && t < best) {
+					best = t;
+					kind = EVENT_PADDLE;
+					target = static_cast<int>(p);
+				}
+			}
+		}
+
+		// blocos, pelas celulas do mapa ao longo do caminho
+		float t;
+		bool hitX;
+		int k = sim.SweepBlocks(x, y, s, s, vx, vy, best, t, hitX);
+		if (k >= 0 && (kind == EVENT_NONE || t < best)) {
+			best = t;
+			kind = hitX ? EVENT_BLOCK_X : EVENT_BLOCK_Y;
+			target = k;
+		}
+
+		if (kind == EVENT_NONE) return;
+
+		BallEvent ev = { ballTime[i] + best, i, version[i], kind, target };
+		queue.push(ev);
+	}
+
+	// nova bola na posicao da bola i, com velocidade (vx, vy)
+	void Split(unsigned i, float vx, float vy)
+	{
+		// mesma contagem do passo fixo (vivas + criadas no tick)
+		if (balls.Total() >= (size_t)sim.config.maxBalls) return;
+		balls.taps[i] = 0;
+
+		float accX = balls.accX[i];
+		float var_x = sim.splitRandom.Uniform(-0.5f * accX, 0.5f * accX);
+		float var_y = sim.splitRandom.Uniform(-0.5f * accX, 0.5f * accX);
+
+		balls.Add(Ball(balls.posX[i], balls.posY[i], vx + var_x, vy + var_y, thickness, thickness));
+		ballTime.push_back(ballTime[i]);
+		version.push_back(0);
+		Push(static_cast<unsigned>(balls.Size() - 1));
+	}
+
+	// acelera a cada colisao com raquete ou bloco
+	void Accelerate(unsigned i)
+	{
+		balls.velX[i] += get_sign(balls.velX[i]) * balls.accX[i];
+		balls.velY[i] += get_sign(balls.velY[i]) * balls.accY[i];
+	}
+
+	void Apply(const BallEvent& ev)
+	{
+		unsigned i = ev.ball;
+		float& vx = balls.velX[i];
+		float& vy = balls.velY[i];
+
+		switch (ev.kind)
+		{
+			case EVENT_WALL_X:
+				vx *= -1.0f;
+				if (++balls.taps[i] > min_taps) Split(i, balls.velX[i], -balls.velY[i]);
+				break;
+
+			case EVENT_WALL_BOTTOM:
+				if (!sim.config.closedBottom) {
+					// saiu por baixo: a bola nao tem mais eventos
+					balls.alive[i] = 0;
+					version[i]++;
+					return;
+				}
+				// parede de baixo fechada: quica como na de cima
+				// fall through
+			case EVENT_WALL_TOP:
+				vy *= -1.0f;
+				if (++balls.taps[i] > min_taps) Split(i, -balls.velX[i], balls.velY[i]);
+				break;
+
+			case EVENT_PADDLE:
+				balls.taps[i]++;
+				vy *= -1.0f;
+				Accelerate(i);
+				if (balls.taps[i] > min_taps) Split(i, -balls.velX[i], balls.velY[i]);
+				break;
+
+			case EVENT_BLOCK_X:
+			case EVENT_BLOCK_Y:
+				balls.taps[i]++;
+				sim.HitBlock(ev.target);
+				Accelerate(i);
+
+				if (ev.kind == EVENT_BLOCK_X) {
+					vx *= -1.0f;
+					if (balls.taps[i] > min_taps) Split(i, balls.velX[i], -balls.velY[i]);
+				}
+				else {
+					vy *= -1.0f;
+					if (balls.taps[i] > min_taps) Split(i, -balls.velX[i], balls.velY[i]);
+				}
+				break;
+		}
+
+		version[i]++;
+		Push(i);
+	}
+
+	Simulation& sim;
+	BallStore& balls;
+	double end;
+
+	// instante (desde o inicio do Advance) em que posX/posY de cada bola vale
+	std::vector<double> ballTime;
+	std::vector<unsigned> version;
+	std::priority_queue<BallEvent, std::vector<BallEvent>, std::greater<BallEvent>> queue;
+};
+
+void Simulation::AdvanceEvents(float seconds)
+{
+	// um intervalo conta como um tick, como no Advance
+	tick++;
+
+	for (auto& paddle : vPaddle) paddle.prev = paddle.pos;
+	vBall.prevX = vBall.posX;
+	vBall.prevY = vBall.posY;
+
+	EventScheduler scheduler(*this, seconds);
+	scheduler.Run();
+
+	vBall.RemoveDead();
+	UpdateHash();
+}
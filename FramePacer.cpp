@@ -0,0 +1,131 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "FramePacer.h"
+#include <cmath>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <time.h>
+#endif
+
+// margem final de espera ocupada: o sleep do Linux/macOS acorda
+// com atraso bem menor que 1 ms, o SDL_Delay do Windows nao
+#if defined(__linux__) || defined(__APPLE__)
+const double spin_margin_ms = 0.5;
+#else
+const double spin_margin_ms = 2.0;
+#endif
+
+FramePacer::FramePacer(double targetRate)
+	:mTargetRate(0.0)
+	,mFrequency(SDL_GetPerformanceFrequency())
+	,mPeriod(0)
+	,mSpinMargin(0)
+	,mDeadline(0)
+	,mLastFrame(0)
+{
+	mSpinMargin = static_cast<Uint64>(mFrequency * spin_margin_ms / 1000.0);
+	SetTargetRate(targetRate);
+	ResetStats();
+}
+
+void FramePacer::SetTargetRate(double targetRate)
+{
+	mTargetRate = targetRate > 0.0 ? targetRate : 0.0;
+	mPeriod = mTargetRate > 0.0
+		? static_cast<Uint64>(mFrequency / mTargetRate)
+		: 0;
+	// recomeca a contagem de prazos no proximo Wait
+	mDeadline = 0;
+}
+
+void FramePacer::Sleep(Uint64 counts)
+{
+#if defined(__linux__)
+	Uint64 ns = counts * 1000000000ull / mFrequency;
+	timespec ts;
+	ts.tv_sec = static_cast<time_t>(ns / 1000000000ull);
+	ts.tv_nsec = static_cast<long>(ns % 1000000000ull);
+	clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+#elif defined(__APPLE__)
+	Uint64 ns = counts * 1000000000ull / mFrequency;
+	timespec ts;
+	ts.tv_sec = static_cast<time_t>(ns / 1000000000ull);
+	ts.tv_nsec = static_cast<long>(ns % 1000000000ull);
+	nanosleep(&ts, NULL);
+#else
+	Uint32 ms = static_cast<Uint32>(counts * 1000 / mFrequency);
+	if (ms > 0) SDL_Delay(ms);
+#endif
+}
+
+double FramePacer::Wait()
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	// primeiro frame: nao ha o que esperar
+	if (mLastFrame == 0)
+	{
+		mLastFrame = now;
+		mDeadline = now + mPeriod;
+		return 0.0;
+	}
+
+	if (mPeriod > 0)
+	{
+		if (mDeadline == 0) mDeadline = mLastFrame + mPeriod;
+
+		// dorme ate perto do prazo...
+		if (now + mSpinMargin < mDeadline)
+		{
+			Sleep(mDeadline - now - mSpinMargin);
+			now = SDL_GetPerformanceCounter();
+		}
+		// ...e gira so no restinho
+		while (now < mDeadline)
+		{
+			now = SDL_GetPerformanceCounter();
+		}
+
+		double jitter = (now - mDeadline) * 1000.0 / mFrequency;
+		mFrames++;
+		mJitterSum += jitter;
+		mJitterSquareSum += jitter * jitter;
+		if (jitter > mJitterMax) mJitterMax = jitter;
+
+		// o proximo prazo e contado a partir do prazo atual, para nao
+		// acumular erro; se atrasamos mais de um frame, recomeca de agora
+		mDeadline += mPeriod;
+		if (mDeadline < now) mDeadline = now + mPeriod;
+	}
+
+	double elapsed = static_cast<double>(now - mLastFrame) / mFrequency;
+	mLastFrame = now;
+	return elapsed;
+}
+
+PacerStats FramePacer::GetStats() const
+{
+	PacerStats stats = { mFrames, 0.0, mJitterMax, 0.0 };
+	if (mFrames > 0)
+	{
+		stats.meanJitterMs = mJitterSum / mFrames;
+		double variance = mJitterSquareSum / mFrames
+			- stats.meanJitterMs * stats.meanJitterMs;
+		stats.stddevJitterMs = variance > 0.0 ? sqrt(variance) : 0.0;
+	}
+	return stats;
+}
+
+void FramePacer::ResetStats()
+{
+	mFrames = 0;
+	mJitterSum = 0.0;
+	mJitterSquareSum = 0.0;
+	mJitterMax = 0.0;
+}
@@ -0,0 +1,56 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include "SDL/SDL.h"
+
+// Estatisticas de ritmo: atraso de cada frame em relacao
+// ao instante em que deveria comecar
+struct PacerStats
+{
+	Uint64 frames;
+	double meanJitterMs;
+	double maxJitterMs;
+	double stddevJitterMs;
+};
+
+// Limita a taxa de frames sem ocupar 100% da CPU: dorme com um relogio
+// de alta resolucao durante a maior parte da espera e so gira no
+// finalzinho, para acordar no instante certo
+class FramePacer
+{
+public:
+	FramePacer(double targetRate = 60.0);
+	// Frames por segundo desejados (0 desliga o limite)
+	void SetTargetRate(double targetRate);
+	double GetTargetRate() const { return mTargetRate; }
+	// Espera ate o inicio do proximo frame e retorna quantos
+	// segundos se passaram desde o frame anterior
+	double Wait();
+	PacerStats GetStats() const;
+	void ResetStats();
+private:
+	void Sleep(Uint64 counts);
+
+	double mTargetRate;
+	// contagens do SDL_GetPerformanceCounter por segundo
+	Uint64 mFrequency;
+	// duracao de um frame, em contagens
+	Uint64 mPeriod;
+	// quanto antes do prazo paramos de dormir e passamos a girar
+	Uint64 mSpinMargin;
+	// instante em que o proximo frame deve comecar
+	Uint64 mDeadline;
+	// instante em que o ultimo frame comecou
+	Uint64 mLastFrame;
+
+	Uint64 mFrames;
+	double mJitterSum;
+	double mJitterSquareSum;
+	double mJitterMax;
+};
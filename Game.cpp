@@ -9,37 +9,46 @@
 #include "Game.h"
 #include <cmath>
 #include <cstdio>
-#include <cstdarg>
+#include <thread>
 
-#define BUFFER_LENGTH 1024
+#include "GlSceneRenderer.h"
+#include "SdlSceneRenderer.h"
 
-#define SCREEN_HEIGHT 480
-#define SCREEN_WIDTH 640
+// frequencia fixa da simulacao (passos por segundo)
+const float sim_rate = 120.0f;
+const float sim_step = 1.0f / sim_rate;
 
-const int min_taps = 3;
-
-const int max_balls = 3;
-
-//sera usado para setar a altura de alguns objetos
-const int thickness = 15;
-
-float get_sign(float n)
-{
-	return n / fabsf(n);
-}
+// taxa de frames padrao (pode ser trocada com SetFrameRate)
+const double frame_rate = 60.0;
 
+// limite de passos por frame, para nao entrar em espiral
+// quando o computador nao consegue acompanhar
+const int max_steps_per_frame = 8;
 
 Game::Game()
 //para criar uma janela
 :mWindow(nullptr)
+//sprites carregados em Initialize
+,mSpritePath("Sprites.json")
 //para fins de renderiza��o na tela
 ,mRenderer(nullptr)
-//para guardar o tempo decorrido no jogo
-,mTicksCount(0)
+,mUseOpenGL(false)
+//para limitar a taxa de frames e a de passos da simulacao
+,mPacer(frame_rate)
+,mSimPacer(sim_rate)
+//tempo ainda nao simulado
+,mAccumulator(0.0f)
 //verificar se o jogo ainda deve continuar sendo executado
 ,mIsRunning(true)
+,mReplayDiverged(false)
+,mTotalDrawCalls(0)
+,mTotalRects(0)
+,mTotalSteps(0)
+,mFreshFrames(0)
 {
-	
+	for (size_t p = 0; p < max_paddles; p++) {
+		mPaddleDir[p] = 0;
+	}
 }
 
 bool Game::Initialize()
@@ -53,6 +62,12 @@ bool Game::Initialize()
 	}
 
 	TTF_Init();
+
+	// o contexto OpenGL precisa ser pedido antes de criar a janela
+	if (mUseOpenGL)
+	{
+		GlSceneRenderer::SetContextAttributes();
+	}
 	
 	// Create an SDL Window
 	mWindow = SDL_CreateWindow(
@@ -61,7 +76,7 @@ bool Game::Initialize()
 		100,	// Top left y-coordinate of window
 		SCREEN_WIDTH,	// Width of window
 		SCREEN_HEIGHT,	// Height of window
-		0		// Flags (0 for no flags set)
+		mUseOpenGL ? SDL_WINDOW_OPENGL : 0		// Flags (0 for no flags set)
 	);
 
 	if (!mWindow)
@@ -70,76 +85,82 @@ bool Game::Initialize()
 		return false;
 	}
 	
-	//// Create SDL renderer
-	mRenderer = SDL_CreateRenderer(
-		mWindow, // Window to create renderer for
-		-1,		 // Usually -1
-		SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
-	);
-
-	if (!mRenderer)
+	font = TTF_OpenFont("VT323-Regular.ttf", 24);
+	if (!mSpritePath.empty() && !mSprites.Load(mSpritePath.c_str()))
+	{
+		SDL_Log("Sem sprites: desenhando cores solidas");
+	}
+	if (!CreateRenderer())
 	{
-		SDL_Log("Failed to create renderer: %s", SDL_GetError());
 		return false;
 	}
+	// os renderizadores ja copiaram a imagem para as texturas deles
+	mSprites.FreePixels();
 
-	font = TTF_OpenFont("VT323-Regular.ttf", 24);
+	vPaddleKeys = std::vector<PaddleKeys>();
+	vPaddleKeys.push_back({ SDL_SCANCODE_A, SDL_SCANCODE_D });
 
-	vPaddle = std::vector<Paddle>();
-	vPaddle.push_back(
-		Paddle(SCREEN_WIDTH/2.0f, 
-			SCREEN_HEIGHT - 2*thickness, 
-			100.0f, 
-			thickness,
-			300.0f,
-			SDL_SCANCODE_A, 
-			SDL_SCANCODE_D)
-	);
-	
-	vBall = std::list<Ball>();
-	vBall.push_back(
-		Ball(SCREEN_WIDTH / 2.0f - thickness / 2.0f,
-			 SCREEN_HEIGHT / 2.0f - thickness / 2.0f,
-			 100.0f,
-			 200.0f, 
-			 thickness, 
-			 thickness)
-	);
-
-	//taps = 0;
-
-	goals = std::vector<int>((size_t)2);
+	// o replay traz a configuracao (e a semente) da partida gravada
+	if (!mReplayPath.empty())
+	{
+		if (!mPlayer.Open(mReplayPath.c_str()))
+		{
+			SDL_Log("Failed to open replay: %s", mReplayPath.c_str());
+			return false;
+		}
+		if (mPlayer.Step() != sim_step)
+		{
+			SDL_Log("Replay step %f does not match %f", mPlayer.Step(), sim_step);
+			return false;
+		}
+		mSimConfig = mPlayer.Config();
+	}
 
-	map = BlockMap(SCREEN_WIDTH - 2 * thickness, SCREEN_HEIGHT / 3.0f - thickness, 7, 5);
+	if (!mRecordPath.empty() && !mRecorder.Open(mRecordPath.c_str(), mSimConfig, sim_step))
+	{
+		SDL_Log("Failed to create replay: %s", mRecordPath.c_str());
+		return false;
+	}
 
-	float width = map.windowWidth / map.matrixWidth;
-	float height = map.windowHeight / map.matrixHeight;
-	float top = thickness;
-	float left = thickness;
+	sim.Initialize(mSimConfig);
 
-	int i = 0;
-	for (auto row : map.matrix) {
-		for (int j = 0; j < map.matrixWidth; j++) {
-			if (row[j] == 1) {
-				float x = left + j * width + thickness / 4.0f;
-				float y = top + i * height + thickness / 4.0f;
-				vBlock.push_back(Block(x, y, width - thickness / 2.0f, height - thickness / 2.0f));
-			}
-		}
-		i++;
+	// espaco para o pior caso, para nao alocar durante o jogo
+	mScene.Reserve(mSimConfig, sim.vBlock.size());
+	for (int k = 0; k < 3; k++) {
+		mSnapshots.Slot(k).from.Reserve(mSimConfig, sim.vBlock.size());
+		mSnapshots.Slot(k).to.Reserve(mSimConfig, sim.vBlock.size());
 	}
 
+	// o primeiro frame ja tem o que desenhar
+	PublishSnapshot();
+	mSnapshots.Update();
+
 	return true;
 }
 
 void Game::RunLoop()
 {
+	// a simulacao anda no ritmo dela mesmo quando o SDL_RenderPresent
+	// (ou o SwapWindow) fica esperando o vsync; a janela, os eventos e
+	// o desenho continuam nesta thread, como o SDL pede
+	std::thread simulation(&Game::SimulationLoop, this);
+
 	while (mIsRunning)
 	{
+		mPacer.Wait();
 		ProcessInput();
-		UpdateGame();
 		GenerateOutput();
 	}
+
+	simulation.join();
+}
+
+void Game::SimulationLoop()
+{
+	while (mIsRunning)
+	{
+		UpdateGame();
+	}
 }
 
 void Game::ProcessInput()
@@ -155,6 +176,7 @@ void Game::ProcessInput()
 				mIsRunning = false;
 				break;
 		}
+		mRenderer->HandleEvent(event);
 	}
 	
 	// Get state of keyboard - 
@@ -173,427 +195,176 @@ void Game::ProcessInput()
 	// W -> move a raquete para cima, 
 	// S -> move a raquete para baixo
 
-	for(auto& paddle:vPaddle){
-		bool was_shown = paddle.onScreen;
-		paddle.dir = 0;
-		if (state[paddle.left])
-		{
-			paddle.dir -= 1;
-			paddle.onScreen = true;
-			if (!was_shown) goals = { 0, 0 };
-		}
-		if (state[paddle.right])
+	for (size_t p = 0; p < max_paddles; p++) {
+		int dir = 0;
+		if (p < vPaddleKeys.size())
 		{
-			paddle.dir += 1;
-			paddle.onScreen = true;
-			if (!was_shown) goals = { 0, 0 };
+			if (state[vPaddleKeys[p].left])
+			{
+				dir -= 1;
+			}
+			if (state[vPaddleKeys[p].right])
+			{
+				dir += 1;
+			}
 		}
-	}	
+		mPaddleDir[p].store(dir, std::memory_order_relaxed);
+	}
 }
 
 void Game::UpdateGame()
 {
-	std::random_device rd;  //Will be used to obtain a seed for the random number engine
-	std::mt19937 gen(rd()); //Standard mersenne_twister_engine seeded with rd()
-
-	// Espere que 16ms tenham passado desde o �ltimo frame - 
-	// limitando os frames
-	while (!SDL_TICKS_PASSED(SDL_GetTicks(), mTicksCount + 16))
-		;
-
-	// Delta time � a diferen�a em ticks do �ltimo frame
-	// (convertido pra segundos) - 
-	// calcula o delta time para atualiza��o do jogo
-	float deltaTime = (SDL_GetTicks() - mTicksCount) / 1000.0f;
+	// Espere o inicio do proximo passo - no ritmo da simulacao, que
+	// roda na sua propria thread, e nao no dos frames.
+	// Delta time � a diferen�a de tempo desde o �ltimo frame
+	// (em segundos)
+	float deltaTime = static_cast<float>(mSimPacer.Wait());
 	
 	// "Clamp" (lima/limita) valor m�ximo de delta time
-	if (deltaTime > 0.05f)
+	if (deltaTime > max_steps_per_frame * sim_step)
 	{
-		deltaTime = 0.05f;
-	}
-
-	// atualize a contagem de ticks par ao pr�ximo frame
-	mTicksCount = SDL_GetTicks();
-	
-	// atualiza a posição da raquete
-	for(auto& paddle:vPaddle){
-		if (paddle.dir != 0)
-		{
-			// velocidade de 300 pixels por segundo
-			paddle.pos.x += paddle.dir * paddle.vel * deltaTime;
-			// verifique que a raquete n�o se move para fora da tela
-			// usamos "thickness", 
-			// que definimos como a altura dos elementos
-
-			if (paddle.pos.x < (paddle.width / 2.0f + thickness))
-			{
-				paddle.pos.x = paddle.width / 2.0f + thickness;
-			}
-			else if (
-				paddle.pos.x > (SCREEN_WIDTH - paddle.width*3.0f/2.0f - thickness))
-			{
-				paddle.pos.x = SCREEN_WIDTH - paddle.width*3.0f/2.0f - thickness;
-			}
-		}
+		deltaTime = max_steps_per_frame * sim_step;
 	}
 
-	//Update Map
-	
-	// atualiza a posição da bola com base na sua velocidade
-	for (Ball& b : vBall)
+	// a simulacao sempre anda em passos de sim_step segundos;
+	// o tempo que sobra fica acumulado para o proximo frame
+	mAccumulator += deltaTime;
+	int steps = 0;
+	while (mAccumulator >= sim_step && !sim.IsOver())
 	{
-		std::uniform_real_distribution<> dis(-0.5 * b.acc.x, 0.5 * b.acc.x);
-
-		float var_x = dis(gen);
-		float var_y = dis(gen);
-
-		//printf("var x: %.2f, var y: %.2f\n", var_x, var_y);
-
-		b.pos.x += b.vel.x * deltaTime;
-		b.pos.y += b.vel.y * deltaTime;
-
-		float b_top = b.pos.y;
-		float b_bottom = b.pos.y + thickness;
-
-		float b_left = b.pos.x;
-		float b_right = b.pos.x + thickness;
-
-		// atualiza a posição da bola se ela colidiu com a raquete
-		for(auto const& paddle : vPaddle) {
-			if (paddle.onScreen &&
-				// bolinha dentro do espaço da raquete
-				b.collide(paddle.pos, paddle.width, paddle.height)
-				&& b.vel.y > 0.0f)
-			{
-				//printf("colidiu\n");
-				b.taps += 1;
-
-				b.vel.y *= -1.0f;
-
-				// acelera a cada colis�o
-				// depois adicionar condi��o de apertar barra de espa�o
-				// sem deltaTime, porque colisão não ocorre em todo frame
-				b.vel.x += get_sign(b.vel.x) * b.acc.x;
-				b.vel.y += get_sign(b.vel.y) * b.acc.y;
-				
-				//printf("vel_x: %.2f\n", b.vel.x);
-				if (b.taps > min_taps && vBall.size() < max_balls) {
-					b.taps = 0;
-
-					vBall.push_back(Ball(b.pos.x, b.pos.y, -b.vel.x + var_x, b.vel.y + var_y, thickness, thickness));
-				}
-			}
-		}
-
-		// atualiza a posição da bola se ela colidiu com algum bloco
-		for (auto& block : vBlock) {
-			if (block.onScreen &&
-				// bolinha dentro do espaço do bloco
-				b.collide(block.pos, block.width, block.height))
-			{
-				b.taps += 1;
-				block.taps += 1;
-
-				// sem deltaTime, porque colisão não ocorre em todo frame
-				b.vel.x += get_sign(b.vel.x) * b.acc.x;
-				b.vel.y += get_sign(b.vel.y) * b.acc.y;
-
-				// colisão à esquerda
-				if (b_right - thickness/2.0f < block.pos.x 
-					&& b.vel.x > 0.0f) {
-					b.vel.x *= -1.0f;
-
-					if (b.taps > min_taps && vBall.size() < max_balls) {
-						b.taps = 0;
-
-						vBall.push_back(Ball(b.pos.x, b.pos.y, b.vel.x + var_x, -b.vel.y + var_y, thickness, thickness));
-					}
-				}
-				// colisão à direita
-				else if (b_left + thickness/2.0f > block.pos.x + block.width
-					     && b.vel.x < 0.0f) {
-					b.vel.x *= -1.0f;
-
-					if (b.taps > min_taps && vBall.size() < max_balls) {
-						b.taps = 0;
-
-						vBall.push_back(Ball(b.pos.x, b.pos.y, b.vel.x + var_x, -b.vel.y + var_y, thickness, thickness));
-					}
-				}
-
-				// colisão de cima
-				if (b_bottom - thickness / 2.0f < block.pos.y
-					&& b.vel.y > 0.0f) {
-					b.vel.y *= -1.0f;
-
-					if (b.taps > min_taps && vBall.size() < max_balls) {
-						b.taps = 0;
-
-						vBall.push_back(Ball(b.pos.x, b.pos.y, -b.vel.x + var_x, b.vel.y + var_y, thickness, thickness));
-					}
-				}
-				// colisão de baixo
-				else if (b_top + thickness / 2.0f > block.pos.y
-					     && b.vel.y < 0.0f) {
-					b.vel.y *= -1.0f;
-
-					if (b.taps > min_taps && vBall.size() < max_balls) {
-						b.taps = 0;
-
-						vBall.push_back(Ball(b.pos.x, b.pos.y, -b.vel.x + var_x, b.vel.y + var_y, thickness, thickness));
-					}
-				}
-
-				if (block.taps > min_taps) {
-					block.onScreen = false;
-				}
-			}
+		// a ultima direcao lida do teclado; jogando um replay, a
+		// entrada vem do arquivo
+		for (size_t p = 0; p < max_paddles; p++) {
+			input.paddleDir[p] = mPaddleDir[p].load(std::memory_order_relaxed);
 		}
-
-		// parede da esquerda
-		if (b_left <= thickness
-			&& b.vel.x < 0.0f)
+		uint64_t expected = 0;
+		if (mPlayer.IsOpen() && !mPlayer.Next(input, expected))
 		{
-			b.vel.x *= -1.0f;
-
-			b.taps += 1;
-			if (b.taps > min_taps && vBall.size() < max_balls) {
-				b.taps = 0;
-
-				vBall.push_back(Ball(b.pos.x, b.pos.y, b.vel.x + var_x, -b.vel.y + var_y, thickness, thickness));
-			}
+			SDL_Log("Replay finished after %ld ticks", mPlayer.Ticks());
+			mIsRunning = false;
+			break;
 		}
-		// parede da direita
-		else if (b_right >= SCREEN_WIDTH - thickness
-			&& b.vel.x > 0.0f)
-		{
-			b.vel.x *= -1.0f;
 
-			b.taps += 1;
-			if (b.taps > min_taps && vBall.size() < max_balls) {
-				b.taps = 0;
+		sim.Step(sim_step, input);
+		mAccumulator -= sim_step;
+		steps++;
 
-				vBall.push_back(Ball(b.pos.x, b.pos.y, b.vel.x + var_x, -b.vel.y + var_y, thickness, thickness));
-			}
-		}
-
-		// parede de cima
-		if (b_top <= thickness 
-			&& b.vel.y < 0.0f)
+		if (mPlayer.IsOpen() || mRecorder.IsOpen())
 		{
-			b.vel.y *= -1.0f;
-
-			b.taps++;
-			if (b.taps > min_taps && vBall.size() < max_balls) {
-				b.taps = 0;
-
-				vBall.push_back(Ball(b.pos.x, b.pos.y, -b.vel.x + var_x, b.vel.y + var_y, thickness, thickness));
+			uint64_t hash = sim.Hash();
+			if (mPlayer.IsOpen() && hash != expected && !mReplayDiverged)
+			{
+				SDL_Log("Replay diverged at tick %ld", mPlayer.Ticks());
+				mReplayDiverged = true;
 			}
-		}
-		// parede de baixo
-		else if (b_bottom >= SCREEN_HEIGHT
-			&& b.vel.y > 0.0f)
-		{
-			b.onScreen = false;
+			mRecorder.Record(input, hash);
 		}
 	}
 
-	auto ball_iter = vBall.begin();
-	while (ball_iter != vBall.end())
+	if (steps > 0)
 	{
-		if (!ball_iter->onScreen)
-		{
-			auto erase = ball_iter;
-			ball_iter++;
-
-			vBall.erase(erase);
-		}
-		else ball_iter++;
+		mTotalSteps += steps;
+		PublishSnapshot();
 	}
 
-	auto block_iter = vBlock.begin();
-	while (block_iter != vBlock.end())
+	if (sim.IsOver()) mIsRunning = false;
+}
+
+void Game::PublishSnapshot()
+{
+	// as cenas do inicio e do fim do ultimo passo; os blocos so sao
+	// refeitos quando algum e acertado
+	SceneSnapshot& snapshot = mSnapshots.Write();
+	BuildScene(sim, 0.0f, snapshot.from);
+	BuildScene(sim, 1.0f, snapshot.to);
+	snapshot.time = SDL_GetPerformanceCounter();
+	snapshot.tick = sim.tick;
+	mSnapshots.Publish();
+}
+
+bool Game::CreateRenderer()
+{
+	if (mUseOpenGL)
 	{
-		if (!block_iter->onScreen)
+		std::unique_ptr<GlSceneRenderer> gl(new GlSceneRenderer());
+		if (gl->Initialize(mWindow, font, mSprites))
 		{
-			auto erase = block_iter;
-			block_iter++;
-
-			vBlock.erase(erase);
+			mRenderer = std::move(gl);
+			SDL_Log("Renderizador: %s", mRenderer->Name());
+			return true;
 		}
-		else block_iter++;
+		// os atributos de 3.3 core atrapalhariam o SDL_Renderer
+		SDL_GL_ResetAttributes();
+		SDL_Log("OpenGL indisponivel, usando o SDL_Renderer");
 	}
-	
-	if (vBall.size() == 0) mIsRunning = false;
-}
-
-void Game::DrawText(const char* fmt, ...) {
-	char buffer[BUFFER_LENGTH];
-
-	va_list rest;
-	va_start(rest, fmt);
-
-	SDL_vsnprintf(buffer, BUFFER_LENGTH, fmt, rest);
-
-	va_end(rest);
-
-	SDL_Color color = {
-		255, 255, 255, 255
-	};
-
-	SDL_Surface* text = TTF_RenderText_Solid(font, buffer, color);
-
-	SDL_Texture* textureText = SDL_CreateTextureFromSurface(mRenderer, text);
-
-	SDL_Rect dest = { 0 };
-
-	SDL_QueryTexture(textureText, NULL, NULL, &dest.w, &dest.h);
-
-	SDL_FreeSurface(text);
-
-	dest.x = thickness;
-	dest.y = 2 * thickness;
 
-	SDL_RenderCopy(mRenderer, textureText, NULL, &dest);
-
-	SDL_DestroyTexture(textureText);
+	std::unique_ptr<SdlSceneRenderer> sdl(new SdlSceneRenderer());
+	if (!sdl->Initialize(mWindow, font, mSprites))
+	{
+		return false;
+	}
+	mRenderer = std::move(sdl);
+	SDL_Log("Renderizador: %s", mRenderer->Name());
+	return true;
 }
 
 //Desenhando a tela do jogo
 void Game::GenerateOutput()
 {
-	// Setamos a cor de fundo para azul
-	SDL_SetRenderDrawColor(
-		mRenderer,
-		0,   // R
-		0,   // G
-		255, // B
-		255  // A
-	);
-	
-	// limpa o back buffer
-	SDL_RenderClear(mRenderer);
-	
-	// paredes brancas
-	SDL_SetRenderDrawColor(mRenderer, 255, 255, 255, 255);
-
-	// parede de cima
-	SDL_Rect wall{
-		0,            // top left x
-		0,            // top left y
-		SCREEN_WIDTH, // width
-		thickness     // height
-	};
-	SDL_RenderFillRect(mRenderer, &wall);
-
-	// desenhamos as outras paredes apenas mudando as 
-	// coordenadas de wall
-	// parede de baixo
-	/*wall.y = SCREEN_HEIGHT - thickness;
-	SDL_RenderFillRect(mRenderer, &wall);*/
-
-	//Parede da direita
-	wall.x = SCREEN_WIDTH - thickness;
-	wall.y = 0;
-	wall.w = thickness;
-	wall.h = SCREEN_WIDTH;
-	SDL_RenderFillRect(mRenderer, &wall);
-
-	wall.x = 0;
-	SDL_RenderFillRect(mRenderer, &wall);
-	
-	// como as posi��es da raquete e da bola ser�o atualizadas 
-	// a cada itera��o do game loop, criamos "membros" na classe
-	// Game.h para tal
+	// o snapshot mais novo; se a simulacao nao publicou desde o ultimo
+	// frame, o mesmo de antes, um pouco mais adiante na interpolacao
+	if (mSnapshots.Update()) mFreshFrames++;
+	const SceneSnapshot& snapshot = mSnapshots.Read();
+
+	// raquetes e bolas interpoladas pelo tempo desde o fim do passo,
+	// entre o estado de antes dele e o de depois (um passo de atraso)
+	double elapsed = static_cast<double>(SDL_GetPerformanceCounter() - snapshot.time) /
+		SDL_GetPerformanceFrequency();
+	float alpha = static_cast<float>(elapsed / sim_step);
+	if (alpha > 1.0f) alpha = 1.0f;
+	LerpScene(snapshot, alpha, mScene);
+
+	mTotalDrawCalls += mRenderer->Render(mScene);
+	mTotalRects += mScene.walls.size() + mScene.blocksVisible + mScene.paddles.size() + mScene.balls.size();
+}
 
-	//mudar a cor da raquete
-	SDL_SetRenderDrawColor(mRenderer, 0, 255, 0, 255);
+void Game::SetFrameRate(double rate)
+{
+	mPacer.SetTargetRate(rate);
+}
 
-	// desenhando a raquete - 
-	// usando mPaddlePos que � uma struct de coordenada 
-	// definida em Game.h
-	
-	for(auto const& paddle : vPaddle){
-		if (paddle.onScreen) {
-			SDL_Rect rPaddle{
-				// static_cast converte de float para inteiros, 
-				// pois SDL_Rect trabalha com inteiros
-				static_cast<int>(paddle.pos.x),
-				static_cast<int>(paddle.pos.y),
-				static_cast<int>(paddle.width),
-				static_cast<int>(paddle.height)
-			};
-			SDL_RenderFillRect(mRenderer, &rPaddle);
-		}
+//Para encerrar o jogo
+void Game::Shutdown()
+{
+	PacerStats stats = mPacer.GetStats();
+	SDL_Log("Frames: %llu, jitter medio %.3f ms, desvio %.3f ms, maximo %.3f ms",
+		(unsigned long long)stats.frames,
+		stats.meanJitterMs, stats.stddevJitterMs, stats.maxJitterMs);
+	if (stats.frames > 0)
+	{
+		// um SDL_RenderFillRect por retangulo seria uma chamada por retangulo
+		SDL_Log("Desenho: %.1f chamadas por frame para %.1f retangulos",
+			(double)mTotalDrawCalls / stats.frames, (double)mTotalRects / stats.frames);
+		SDL_Log("Snapshots: novos em %llu de %llu frames", mFreshFrames,
+			(unsigned long long)stats.frames);
 	}
-	
-	// desenhando a bola - 
-	// usando mBallPos que � uma struct de coordenadas 
-	// definida como membro em Game.h
-	
-	//mudar a cor do renderizador para as bolinhas
-	SDL_SetRenderDrawColor(
-		mRenderer,
-		255, // R
-		0,   // G
-		0,   // B
-		255  // A
-	);
-
-	for (Ball& b : vBall)
+	PacerStats simStats = mSimPacer.GetStats();
+	SDL_Log("Simulacao: %llu passos em %llu esperas, jitter medio %.3f ms, maximo %.3f ms",
+		mTotalSteps, (unsigned long long)simStats.frames,
+		simStats.meanJitterMs, simStats.maxJitterMs);
+	if (mRenderer)
 	{
-		// Draw ball
-		
-		//Revisar posição da Bola
-		SDL_Rect ball{
-			static_cast<int>(b.pos.x),
-			static_cast<int>(b.pos.y),
-			thickness,
-			thickness
-		};
-
-		SDL_RenderFillRect(mRenderer, &ball);
+		mRenderer->LogStats(stats.frames);
 	}
 
-	//mudar a cor do renderizador para os blocos
-	SDL_SetRenderDrawColor(
-		mRenderer,
-		255, // R
-		255, // G
-		0,   // B
-		255  // A
-	);
-
-	for (Block const &block : vBlock) {
-		if (block.onScreen == true) {
-			SDL_Rect renderedBlock{
-				static_cast<int>(block.pos.x),
-				static_cast<int>(block.pos.y),
-				block.width,
-				block.height
-			};
-
-			SDL_RenderFillRect(mRenderer, &renderedBlock);
-		}
+	if (mRecorder.IsOpen())
+	{
+		SDL_Log("Replay: %ld ticks gravados em %s", mRecorder.Ticks(), mRecordPath.c_str());
+		mRecorder.Close();
 	}
+	mPlayer.Close();
 
-	SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 255);
-
-	//printf("gols sofridos:");
-	//printf(" %3d\n", goals[0]);
-
-	//DrawText("\n\nGols sofridos: %3d\n", goals[0]);
-
-	SDL_SetRenderDrawColor(mRenderer, 255, 0, 0, 255);
-	
-	// Swap front buffer and back buffer
-	SDL_RenderPresent(mRenderer);
-}
-
-//Para encerrar o jogo
-void Game::Shutdown()
-{
-	SDL_DestroyRenderer(mRenderer);//encerra o renderizador
+	mRenderer.reset();//encerra o renderizador
 	SDL_DestroyWindow(mWindow);//encerra a janela aberta
 	SDL_Quit();//encerra o jogo
 }
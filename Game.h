@@ -7,123 +7,29 @@
 // ----------------------------------------------------------------
 
 #pragma once
-#include <cmath>
-#include <list>
-#include <random>
+#include <atomic>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "SDL/SDL.h"
 #include "SDL/SDL_ttf.h"
 
-// Vector2 struct just stores x/y coordinates
-// (for now)
-struct Vector2
-{
-	float x;
-	float y;
-};
-
-class Ball {
-public:
-	Vector2 pos;
-	Vector2 vel;
-	Vector2 acc;
-	float width;
-	float height;
-	bool onScreen;
-	int taps;
-		
-	Ball(float x, float y, float vx, float vy, float w, float h)
-		:pos({x, y}), vel({vx, vy}), height(h), width(w), taps(0)
-	{
-		onScreen = true;
-		acc = { 0.00f * fabsf(vx), 0.00f * fabsf(vy) };
-	}
-
-	bool collide(Vector2 o_pos, float o_width, float o_height){
-		return ((pos.x < o_pos.x + o_width && o_pos.x < pos.x + width)
-			&& (pos.y < o_pos.y + o_height && o_pos.y < pos.y + height));
-	}
+#include "FramePacer.h"
+#include "Replay.h"
+#include "Scene.h"
+#include "SceneRenderer.h"
+#include "Simulation.h"
+#include "SpriteSheet.h"
+#include "TripleBuffer.h"
 
-};
-
-class Paddle {
-public:
-	Vector2 pos;
-	float width;
-	float height;
-	float vel;
+// Teclas que controlam cada raquete
+struct PaddleKeys
+{
 	SDL_Scancode left;
 	SDL_Scancode right;
-	int dir;
-	bool onScreen;
-//	int goals_taken; 
-
-	Paddle(float x, float y, float w, float h, float v, SDL_Scancode l, SDL_Scancode r, bool show = true)
-		:pos({x, y}), width(w), height(h), vel(v), left(l), right(r), dir(0), onScreen(show)
-	{
-		//constructor
-	}
-
-//	bool collide()
-
-};
-
-//Block class
-class Block {
-public:
-	Vector2 pos;
-	float height;
-	float width;
-	bool onScreen;
-	int taps;
-
-	Block(float x, float y, float w, float h, bool show = true)
-		:pos({ x, y }), height(h), width(w), onScreen(show), taps(0)
-	{
-		//constructor
-	}
-
 };
 
-//Blockmap class
-class BlockMap {
-//private:
-//	std::vector<std::vector<int>> matrix;
-
-public:
-	std::vector<std::vector<int>> matrix;
-	float windowWidth;
-	float windowHeight;
-
-	float matrixWidth;
-	float matrixHeight;
-	BlockMap(): windowWidth(0), windowHeight(0), matrixWidth(0), matrixHeight(0)
-	{
-	
-	}
-	BlockMap(float w_width, float w_height, int m_width, int m_height)
-		: windowWidth(w_width), windowHeight(w_height), matrixWidth(m_width), matrixHeight(m_height)
-	{
-		matrix.resize(m_height);
-
-		for (auto& row : matrix) {
-			row.resize(m_width, 1);
-		}
-
-		//matrix[0].resize(m_width, 0);
-		//matrix[1] = { 0,1,1,0,1,1,0 };
-		//matrix[2].resize(m_width, 0);
-		//matrix[3] = { 0,0,1,1,1,0,0 };
-		//matrix[4].resize(m_width, 0);
-	}
-
-	void Initialize(){
-	}
-
-};
-
-
 // Game class
 class Game
 {
@@ -131,43 +37,89 @@ public:
 	Game();
 	// Initialize the game
 	bool Initialize();
-	// Runs the game loop until the game is over
+	// Runs the game loop until the game is over: a simulacao numa thread
+	// propria, no ritmo fixo dela, e entrada e desenho nesta
 	void RunLoop();
 	// Shutdown the game
 	void Shutdown();
+	// Frames per second target (0 for no limit)
+	void SetFrameRate(double rate);
+	// Parametros da partida (antes de Initialize)
+	void SetSimConfig(const SimConfig& config) { mSimConfig = config; }
+	// Grava a partida num arquivo de replay (antes de Initialize)
+	void SetRecordPath(const std::string& path) { mRecordPath = path; }
+	// Joga um replay em vez de ler o teclado; a configuracao vem
+	// do arquivo (antes de Initialize)
+	void SetReplayPath(const std::string& path) { mReplayPath = path; }
+	// Desenha com OpenGL 3.3 em vez do SDL_Renderer (antes de Initialize)
+	void SetUseOpenGL(bool useOpenGL) { mUseOpenGL = useOpenGL; }
+	// JSON do sprite sheet; vazio desenha cores solidas (antes de Initialize)
+	void SetSpritePath(const std::string& path) { mSpritePath = path; }
 private:
 	// Helper functions for the game loop
 	void ProcessInput();
+	// Thread da simulacao: UpdateGame ate o jogo acabar
+	void SimulationLoop();
 	void UpdateGame();
-
-	void DrawText(const char*, ...);
+	// Publica o estado de sim para o desenho
+	void PublishSnapshot();
 
 	void GenerateOutput();
+	// Cria o renderizador pedido, ou o do SDL se o OpenGL falhar
+	bool CreateRenderer();
 
 	// Window created by SDL
 	SDL_Window* mWindow;
-	// Renderer for 2D drawing
-	SDL_Renderer* mRenderer;
+	// sprites de todos os objetos (antes do renderizador, que guarda
+	// os retangulos deles)
+	std::string mSpritePath;
+	SpriteSheet mSprites;
+	// Renderer for 2D drawing (SDL_Renderer ou OpenGL)
+	std::unique_ptr<SceneRenderer> mRenderer;
+	bool mUseOpenGL;
+	// ultimo estado de sim, publicado pela thread da simulacao a cada
+	// passo e lido pela do desenho sem que uma espere a outra
+	TripleBuffer<SceneSnapshot> mSnapshots;
+	// o que o renderizador desenha, interpolado a cada frame a partir
+	// do snapshot mais novo
+	Scene mScene;
 
 	TTF_Font* font;
 
-	// Number of ticks since start of game
-	Uint32 mTicksCount;
-	// Game should continue to run
-
-	bool mIsRunning;
-	
-	// Pong specific
-	std::list<Ball> vBall;
-
-	std::vector<Paddle> vPaddle;
-
-	BlockMap map;
-
-	std::list<Block> vBlock;
-
-	//int taps;
-
-	//int goals_left;
-	std::vector<int> goals;
+	// Limita a taxa de frames e mede o atraso de cada frame
+	FramePacer mPacer;
+	// O mesmo para os passos da simulacao, na thread dela
+	FramePacer mSimPacer;
+	// Tempo acumulado que ainda nao virou passo da simulacao
+	float mAccumulator;
+	// Game should continue to run (as duas threads leem e escrevem)
+
+	std::atomic<bool> mIsRunning;
+
+	// Estado do jogo (bolas, raquetes, blocos)
+	Simulation sim;
+	SimConfig mSimConfig;
+
+	// Direcao de cada raquete lida do teclado em ProcessInput, que a
+	// thread da simulacao copia para input a cada tick
+	std::atomic<int> mPaddleDir[max_paddles];
+	// Entrada do proximo tick (so a thread da simulacao mexe)
+	SimInput input;
+
+	std::vector<PaddleKeys> vPaddleKeys;
+
+	// Replay sendo gravado e/ou jogado
+	std::string mRecordPath;
+	std::string mReplayPath;
+	ReplayRecorder mRecorder;
+	ReplayPlayer mPlayer;
+	// o replay ja divergiu (so avisa no primeiro tick diferente)
+	bool mReplayDiverged;
+
+	// chamadas de desenho e retangulos desenhados, para o resumo do Shutdown
+	unsigned long long mTotalDrawCalls;
+	unsigned long long mTotalRects;
+	// passos dados e frames que pegaram um snapshot novo
+	unsigned long long mTotalSteps;
+	unsigned long long mFreshFrames;
 };
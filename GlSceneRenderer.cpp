@@ -0,0 +1,469 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "GlSceneRenderer.h"
+#include <cstddef>
+#include <cstring>
+
+// O quad sai de gl_VertexID (strip de 4 vertices), entao so as instancias
+// vao em VBO. Pixels viram NDC com y para baixo, como no SDL_Renderer.
+static const char* vertex_source =
+	"#version 330 core\n"
+	"layout(location = 0) in vec4 inRect;\n"
+	"layout(location = 1) in vec4 inUv;\n"
+	"layout(location = 2) in vec4 inColor;\n"
+	"uniform vec2 uScreen;\n"
+	"out vec2 fragUv;\n"
+	"flat out int fragSolid;\n"
+	"out vec4 fragColor;\n"
+	"void main()\n"
+	"{\n"
+	"	vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+	"	vec2 pos = inRect.xy + corner * inRect.zw;\n"
+	"	gl_Position = vec4(pos.x / uScreen.x * 2.0 - 1.0, 1.0 - pos.y / uScreen.y * 2.0, 0.0, 1.0);\n"
+	"	fragUv = mix(inUv.xy, inUv.zw, corner);\n"
+	"	fragSolid = inUv.x < 0.0 ? 1 : 0;\n"
+	"	fragColor = inColor;\n"
+	"}\n";
+
+static const char* fragment_source =
+	"#version 330 core\n"
+	"in vec2 fragUv;\n"
+	"flat in int fragSolid;\n"
+	"in vec4 fragColor;\n"
+	"uniform sampler2D uAtlas;\n"
+	"out vec4 outColor;\n"
+	"void main()\n"
+	"{\n"
+	"	outColor = fragSolid != 0 ? fragColor : fragColor * texture(uAtlas, fragUv);\n"
+	"}\n";
+
+// instancias por regiao do anel no comeco; dobra quando falta
+const size_t initial_instances = 256;
+
+static GLuint CompileShader(GLenum type, const char* source)
+{
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, 1, &source, nullptr);
+	glCompileShader(shader);
+
+	GLint ok = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+	if (!ok)
+	{
+		char log[1024];
+		glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+		SDL_Log("Failed to compile shader: %s", log);
+		glDeleteShader(shader);
+		return 0;
+	}
+	return shader;
+}
+
+GlSceneRenderer::GlSceneRenderer()
+	:mWindow(nullptr)
+	,mContext(nullptr)
+	,mProgram(0)
+	,mScreenLocation(-1)
+	,mVertexArray(0)
+	,mInstanceBuffer(0)
+	,mTexture(0)
+	,mSheet(nullptr)
+	,mHasText(false)
+	,mTextTop(0)
+	,mTextureWidth(1.0f)
+	,mTextureHeight(1.0f)
+	,mPersistent(false)
+	,mMapped(nullptr)
+	,mCapacity(0)
+	,mRegion(0)
+	,mTotalInstances(0)
+	,mFenceWaits(0)
+{
+	for (int r = 0; r < ring_regions; r++) mFences[r] = nullptr;
+}
+
+GlSceneRenderer::~GlSceneRenderer()
+{
+	Release();
+}
+
+void GlSceneRenderer::SetContextAttributes()
+{
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+#ifdef __APPLE__
+	// o macOS so da contexto core forward-compatible
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG);
+#endif
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+}
+
+bool GlSceneRenderer::Initialize(SDL_Window* window, TTF_Font* font, const SpriteSheet& sprites)
+{
+	mWindow = window;
+	mContext = SDL_GL_CreateContext(window);
+	if (!mContext)
+	{
+		SDL_Log("Failed to create OpenGL context: %s", SDL_GetError());
+		return false;
+	}
+
+	// no perfil core o GLEW precisa do glewExperimental para achar
+	// as funcoes de 3.3
+	glewExperimental = GL_TRUE;
+	if (glewInit() != GLEW_OK || !GLEW_VERSION_3_3)
+	{
+		SDL_Log("OpenGL 3.3 not available");
+		Release();
+		return false;
+	}
+	// o glewInit deixa um GL_INVALID_ENUM no perfil core
+	glGetError();
+
+	SDL_Log("OpenGL: %s, %s", (const char*)glGetString(GL_RENDERER),
+		(const char*)glGetString(GL_VERSION));
+
+	// mesmo vsync do SDL_RENDERER_PRESENTVSYNC
+	SDL_GL_SetSwapInterval(1);
+
+	if (!CreateProgram())
+	{
+		Release();
+		return false;
+	}
+
+	glGenVertexArrays(1, &mVertexArray);
+	glBindVertexArray(mVertexArray);
+	for (GLuint a = 0; a < 3; a++) {
+		glEnableVertexAttribArray(a);
+		glVertexAttribDivisor(a, 1);
+	}
+
+	mPersistent = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+	if (!ReserveInstances(initial_instances))
+	{
+		Release();
+		return false;
+	}
+	SDL_Log("OpenGL: instancias por %s", mPersistent ? "VBO mapeado persistente" : "glBufferSubData");
+
+	if (!CreateTexture(font, sprites))
+	{
+		SDL_Log("Sem sprites nem texto: so cores solidas");
+	}
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glDisable(GL_DEPTH_TEST);
+
+	GLenum error = glGetError();
+	if (error != GL_NO_ERROR)
+	{
+		SDL_Log("OpenGL error 0x%04x during setup", error);
+		Release();
+		return false;
+	}
+	return true;
+}
+
+bool GlSceneRenderer::CreateProgram()
+{
+	GLuint vertex = CompileShader(GL_VERTEX_SHADER, vertex_source);
+	GLuint fragment = CompileShader(GL_FRAGMENT_SHADER, fragment_source);
+	if (!vertex || !fragment)
+	{
+		if (vertex) glDeleteShader(vertex);
+		if (fragment) glDeleteShader(fragment);
+		return false;
+	}
+
+	mProgram = glCreateProgram();
+	glAttachShader(mProgram, vertex);
+	glAttachShader(mProgram, fragment);
+	glLinkProgram(mProgram);
+	glDeleteShader(vertex);
+	glDeleteShader(fragment);
+
+	GLint ok = GL_FALSE;
+	glGetProgramiv(mProgram, GL_LINK_STATUS, &ok);
+	if (!ok)
+	{
+		char log[1024];
+		glGetProgramInfoLog(mProgram, sizeof(log), nullptr, log);
+		SDL_Log("Failed to link shader: %s", log);
+		return false;
+	}
+
+	glUseProgram(mProgram);
+	mScreenLocation = glGetUniformLocation(mProgram, "uScreen");
+	glUniform2f(mScreenLocation, static_cast<float>(SCREEN_WIDTH), static_cast<float>(SCREEN_HEIGHT));
+	glUniform1i(glGetUniformLocation(mProgram, "uAtlas"), 0);
+	return true;
+}
+
+bool GlSceneRenderer::CreateTexture(TTF_Font* font, const SpriteSheet& sprites)
+{
+	SDL_Surface* text = mText.BuildSurface(font);
+	if (!text && font)
+	{
+		SDL_Log("Failed to build text atlas: %s", SDL_GetError());
+	}
+	if (sprites.IsLoaded()) mSheet = &sprites;
+	if (!text && !mSheet) return false;
+
+	int spriteWidth = mSheet ? mSheet->Width() : 0;
+	int spriteHeight = mSheet ? mSheet->Height() : 0;
+	int width = text && text->w > spriteWidth ? text->w : spriteWidth;
+	int height = spriteHeight + (text ? text->h : 0);
+
+	glGenTextures(1, &mTexture);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, mTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	// sprites em cima: os pixels do SOIL ja sao bytes R, G, B, A
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	if (mSheet)
+	{
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, spriteWidth, spriteHeight,
+			GL_RGBA, GL_UNSIGNED_BYTE, mSheet->Pixels());
+	}
+
+	// glifos embaixo: RGBA8888 do SDL e um Uint32 por pixel com R no byte
+	// alto, que e exatamente GL_UNSIGNED_INT_8_8_8_8
+	if (text)
+	{
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, text->pitch / 4);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, spriteHeight, text->w, text->h,
+			GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, text->pixels);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		SDL_FreeSurface(text);
+		mHasText = true;
+	}
+
+	mTextTop = spriteHeight;
+	mTextureWidth = static_cast<float>(width);
+	mTextureHeight = static_cast<float>(height);
+	return true;
+}
+
+bool GlSceneRenderer::ReserveInstances(size_t count)
+{
+	if (count <= mCapacity) return true;
+
+	size_t capacity = mCapacity ? mCapacity : initial_instances;
+	while (capacity < count) capacity *= 2;
+
+	// o buffer de ARB_buffer_storage e imutavel: espera a GPU largar
+	// todas as regioes e cria outro maior
+	for (int r = 0; r < ring_regions; r++) WaitRegion(r);
+	if (mInstanceBuffer)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+		if (mMapped) glUnmapBuffer(GL_ARRAY_BUFFER);
+		glDeleteBuffers(1, &mInstanceBuffer);
+		mInstanceBuffer = 0;
+		mMapped = nullptr;
+	}
+
+	GLsizeiptr bytes = static_cast<GLsizeiptr>(capacity * ring_regions * sizeof(Instance));
+	glGenBuffers(1, &mInstanceBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+	if (mPersistent)
+	{
+		// coerente: o que a CPU escreve aparece para a GPU sem flush
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, flags);
+		mMapped = static_cast<Instance*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, flags));
+		if (!mMapped) return false;
+	}
+	else
+	{
+		glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_DYNAMIC_DRAW);
+		mStaging.resize(capacity);
+	}
+
+	mCapacity = capacity;
+	return true;
+}
+
+void GlSceneRenderer::WaitRegion(int region)
+{
+	GLsync& fence = mFences[region];
+	if (!fence) return;
+
+	// quase sempre ja passou: com 3 regioes a GPU teria que estar dois
+	// frames atrasada para a CPU esperar aqui
+	GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		mFenceWaits++;
+		do {
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+		} while (result == GL_TIMEOUT_EXPIRED);
+	}
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+size_t GlSceneRenderer::WriteInstances(const Scene& scene, Instance* out) const
+{
+	size_t n = 0;
+	auto solid = [&](const SDL_Rect& r, Uint8 red, Uint8 green, Uint8 blue) -> Instance& {
+		Instance& i = out[n++];
+		i.rect[0] = static_cast<float>(r.x);
+		i.rect[1] = static_cast<float>(r.y);
+		i.rect[2] = static_cast<float>(r.w);
+		i.rect[3] = static_cast<float>(r.h);
+		i.uv[0] = -1.0f;
+		i.uv[1] = i.uv[2] = i.uv[3] = 0.0f;
+		i.color[0] = red;
+		i.color[1] = green;
+		i.color[2] = blue;
+		i.color[3] = 255;
+		return i;
+	};
+	// source em pixels da textura, a partir da linha top
+	auto textured = [&](const SDL_Rect& r, const SDL_Rect& source, int top) {
+		Instance& i = solid(r, 255, 255, 255);
+		i.uv[0] = source.x / mTextureWidth;
+		i.uv[1] = (top + source.y) / mTextureHeight;
+		i.uv[2] = (source.x + source.w) / mTextureWidth;
+		i.uv[3] = (top + source.y + source.h) / mTextureHeight;
+	};
+
+	// mesma ordem de camadas do SdlSceneRenderer: paredes, blocos,
+	// raquetes, bolas e o HUD por cima
+	if (mSheet)
+	{
+		const SDL_Rect& wall = mSheet->Rect(mSheet->Wall());
+		const SDL_Rect& paddle = mSheet->Rect(mSheet->Paddle());
+		const SDL_Rect& ball = mSheet->Rect(mSheet->Ball());
+		for (auto const& rect : scene.walls) textured(rect, wall, 0);
+		for (auto const& block : scene.blocks) {
+			if (block.visible) textured(block.rect, mSheet->Rect(mSheet->Block(block.taps)), 0);
+		}
+		for (auto const& rect : scene.paddles) textured(rect, paddle, 0);
+		for (auto const& rect : scene.balls) textured(rect, ball, 0);
+	}
+	else
+	{
+		// paredes brancas, blocos amarelos, raquetes verdes, bolas vermelhas
+		for (auto const& wall : scene.walls) solid(wall, 255, 255, 255);
+		for (auto const& block : scene.blocks) {
+			if (block.visible) solid(block.rect, 255, 255, 0);
+		}
+		for (auto const& paddle : scene.paddles) solid(paddle, 0, 255, 0);
+		for (auto const& ball : scene.balls) solid(ball, 255, 0, 0);
+	}
+
+	if (mHasText)
+	{
+		for (int k = 0; k < HUD_LABELS; k++) {
+			const HudText& label = scene.hud[k];
+			mText.ForEachGlyph(label.text, label.x, label.y,
+				[&](const SDL_Rect& glyph, const SDL_Rect& dest) {
+				textured(dest, glyph, mTextTop);
+			});
+		}
+	}
+	return n;
+}
+
+int GlSceneRenderer::Render(const Scene& scene)
+{
+	// limite de cima: um quad por retangulo e por caractere
+	size_t count = scene.walls.size() + scene.blocks.size() + scene.paddles.size() + scene.balls.size();
+	for (int k = 0; k < HUD_LABELS; k++) count += strlen(scene.hud[k].text);
+	if (!ReserveInstances(count)) return 0;
+
+	WaitRegion(mRegion);
+	size_t first = static_cast<size_t>(mRegion) * mCapacity;
+	Instance* out = mPersistent ? mMapped + first : mStaging.data();
+	size_t written = WriteInstances(scene, out);
+
+	glBindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+	if (!mPersistent && written > 0)
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(Instance), written * sizeof(Instance), out);
+	}
+
+	int w = SCREEN_WIDTH, h = SCREEN_HEIGHT;
+	SDL_GL_GetDrawableSize(mWindow, &w, &h);
+	glViewport(0, 0, w, h);
+
+	// fundo azul
+	glClearColor(0.0f, 0.0f, 1.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	int drawCalls = 1;
+
+	if (written > 0)
+	{
+		// GL 3.3 nao tem base instance: os atributos apontam para a regiao
+		// deste frame
+		const char* base = reinterpret_cast<const char*>(first * sizeof(Instance));
+		GLsizei stride = sizeof(Instance);
+		glBindVertexArray(mVertexArray);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, base + offsetof(Instance, rect));
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, base + offsetof(Instance, uv));
+		glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, base + offsetof(Instance, color));
+
+		glUseProgram(mProgram);
+		glActiveTexture(GL_TEXTURE0);
+		// a unica textura do frame: sprites e glifos
+		glBindTexture(GL_TEXTURE_2D, mTexture);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(written));
+		drawCalls++;
+	}
+
+	mFences[mRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	mRegion = (mRegion + 1) % ring_regions;
+	mTotalInstances += written;
+
+	// Swap front buffer and back buffer
+	SDL_GL_SwapWindow(mWindow);
+	return drawCalls;
+}
+
+void GlSceneRenderer::LogStats(unsigned long long frames) const
+{
+	if (frames == 0) return;
+	SDL_Log("OpenGL: %.1f instancias por frame, %llu esperas de fence",
+		(double)mTotalInstances / frames, mFenceWaits);
+}
+
+void GlSceneRenderer::Release()
+{
+	if (!mContext) return;
+
+	for (int r = 0; r < ring_regions; r++) {
+		if (mFences[r]) glDeleteSync(mFences[r]);
+		mFences[r] = nullptr;
+	}
+	if (mInstanceBuffer)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+		if (mMapped) glUnmapBuffer(GL_ARRAY_BUFFER);
+		glDeleteBuffers(1, &mInstanceBuffer);
+	}
+	if (mVertexArray) glDeleteVertexArrays(1, &mVertexArray);
+	if (mTexture) glDeleteTextures(1, &mTexture);
+	if (mProgram) glDeleteProgram(mProgram);
+	mInstanceBuffer = mVertexArray = mTexture = mProgram = 0;
+	mMapped = nullptr;
+	mCapacity = 0;
+
+	SDL_GL_DeleteContext(mContext);
+	mContext = nullptr;
+}
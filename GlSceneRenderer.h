@@ -0,0 +1,107 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <vector>
+
+#include "GL/glew.h"
+#include "SDL/SDL.h"
+#include "SDL/SDL_ttf.h"
+
+#include "SceneRenderer.h"
+#include "SpriteSheet.h"
+#include "TextAtlas.h"
+
+// Desenho com OpenGL 3.3 core: cada retangulo da cena (paredes, blocos,
+// raquetes, bolas e glifos do HUD) vira uma instancia de um quad, com
+// posicao, coordenadas na textura e cor. Sprites e glifos ficam numa
+// textura so (sprites em cima, glifos embaixo), ligada uma vez por
+// frame. As instancias do frame sao escritas direto num VBO mapeado de
+// forma persistente (ARB_buffer_storage) e a cena inteira sai num
+// glDrawArraysInstanced, na mesma ordem de camadas do SdlSceneRenderer.
+//
+// O VBO e um anel de ring_regions regioes protegidas por fences: a CPU
+// escreve o frame N enquanto a GPU ainda le os anteriores. Sem
+// ARB_buffer_storage as instancias vao por glBufferSubData.
+//
+// Roda no llvmpipe do Mesa (GL 4.5 core), entao da para testar sem GPU.
+class GlSceneRenderer : public SceneRenderer
+{
+public:
+	GlSceneRenderer();
+	~GlSceneRenderer();
+
+	// Cria o contexto na janela, que deve ter sido criada com
+	// SDL_WINDOW_OPENGL depois de SetContextAttributes. false se o
+	// driver nao tem GL 3.3 (o Game cai para o SdlSceneRenderer).
+	// sprites precisa durar tanto quanto o renderizador (os pixels, so
+	// ate aqui); sem ele carregado, cores solidas.
+	bool Initialize(SDL_Window* window, TTF_Font* font, const SpriteSheet& sprites);
+	// Pede um contexto 3.3 core (antes de SDL_CreateWindow)
+	static void SetContextAttributes();
+
+	const char* Name() const override { return "OpenGL 3.3"; }
+	int Render(const Scene& scene) override;
+	void LogStats(unsigned long long frames) const override;
+
+private:
+	static const int ring_regions = 3;
+
+	// Um quad: rect em pixels (x, y, w, h), uv na textura (u0, v0, u1,
+	// v1; u0 < 0 para cor solida) e cor RGBA
+	struct Instance
+	{
+		float rect[4];
+		float uv[4];
+		Uint8 color[4];
+	};
+
+	bool CreateProgram();
+	// Junta sprites e glifos numa textura; false se nao tem nenhum dos dois
+	bool CreateTexture(TTF_Font* font, const SpriteSheet& sprites);
+	// Garante count instancias por regiao, recriando o VBO se precisar
+	bool ReserveInstances(size_t count);
+	// Espera a GPU terminar de ler a regiao
+	void WaitRegion(int region);
+	void Release();
+
+	// Escreve as instancias da cena em out, na ordem de desenho
+	size_t WriteInstances(const Scene& scene, Instance* out) const;
+
+	SDL_Window* mWindow;
+	SDL_GLContext mContext;
+
+	GLuint mProgram;
+	GLint mScreenLocation;
+	GLuint mVertexArray;
+	GLuint mInstanceBuffer;
+	GLuint mTexture;
+
+	// sprites (nullptr sem eles) e glifos do HUD (a partir da linha
+	// mTextTop da textura), com o tamanho da textura para as uv
+	const SpriteSheet* mSheet;
+	TextAtlas mText;
+	bool mHasText;
+	int mTextTop;
+	float mTextureWidth;
+	float mTextureHeight;
+
+	// VBO mapeado (nullptr sem ARB_buffer_storage) e instancias por regiao
+	bool mPersistent;
+	Instance* mMapped;
+	size_t mCapacity;
+	// copia local para o glBufferSubData, sem ARB_buffer_storage
+	std::vector<Instance> mStaging;
+	// regiao do proximo frame e a fence do ultimo frame que usou cada uma
+	int mRegion;
+	GLsync mFences[ring_regions];
+
+	// para o resumo do Shutdown
+	unsigned long long mTotalInstances;
+	unsigned long long mFenceWaits;
+};
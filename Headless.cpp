@@ -0,0 +1,550 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+// Executavel headless: roda a simulacao sem janela e sem renderizador
+// e mede quantos ticks por segundo ela consegue processar.
+//
+// uso: Headless [--ticks N] [--dt segundos] [--blocks COLUNASxLINHAS]
+//               [--max-balls N] [--closed-bottom] [--report TICKS]
+//               [--threads N] [--bench-collide CONSULTAS] [--events]
+//               [--seed N] [--record ARQUIVO] [--replay ARQUIVO]
+//               [--diff ARQUIVO1 ARQUIVO2] [--check-threads N]
+//               [--load-snapshot ARQUIVO] [--save-snapshot ARQUIVO]
+//               [--bench-clone N] [--envs N] [--pixels LARGURAxALTURA]
+//               [--rgb] [--frame ARQUIVO] [--shm NOME] [--slots N]
+//               [--frame-skip K]
+//
+// Cenario com muitas bolas (a contagem sobe ate o limite e os ticks/s
+// sao impressos a cada 1000 ticks):
+//   Headless --max-balls 20000 --closed-bottom --report 1000
+//
+// Modo por eventos (--events): cada "tick" avanca dt segundos de uma vez,
+// pulando de colisao em colisao; com dt grande mede o tempo simulado por
+// segundo de relogio:
+//   Headless --events --dt 1 --ticks 600 --closed-bottom --max-balls 1000
+//
+// Replays: --record grava a partida (com a raquete automatica);
+// --replay joga o arquivo na velocidade maxima e confere o hash do
+// estado a cada tick, parando no primeiro tick que divergir.
+//
+// Determinismo: --diff compara dois replays (por exemplo, gravados
+// antes e depois de uma mudanca) e imprime o primeiro tick diferente;
+// --check-threads N roda o cenario com 1 e com N threads lado a lado
+// e compara o hash do estado a cada tick.
+//
+// Snapshots: --load-snapshot comeca do estado salvo em vez de uma
+// partida nova; --save-snapshot salva o estado final; --bench-clone N
+// copia o estado final N vezes (Simulation::CopyFrom) e mede o tempo.
+//
+// Ambientes em lote (VecEnv): --envs N avanca N partidas juntas por
+// --ticks passos, com uma politica simples que segue a bola observada,
+// e mede os passos de ambiente por segundo (--threads divide os ambientes).
+// --pixels tambem desenha a observacao em pixels de todos os ambientes a
+// cada passo (cinza, ou RGB com --rgb); --frame salva o ultimo quadro do
+// primeiro ambiente como PGM/PPM:
+//   Headless --envs 256 --ticks 1000 --pixels 84x84 --frame obs.pgm
+//
+// Frame skip: --frame-skip K repete a acao da raquete por K ticks a cada
+// decisao (Simulation::StepRepeat), no cenario normal, em --envs e em
+// --shm; o hash e a observacao so sao calculados no ultimo tick.
+//
+// Treino em outro processo: --shm NOME serve os ambientes de --envs (1 se
+// nao informado) por memoria compartilhada, num anel de --slots passos
+// (protocolo em SharedEnv.h), ate o cliente pedir para sair. O cliente de
+// referencia e o benchmark estao em SharedEnvClient.c:
+//   Headless --shm arkanoid --envs 64 --pixels 84x84 &
+//   SharedEnvClient arkanoid 100000
+
+#include "CollideBench.h"
+#include "Replay.h"
+#include "SharedEnvServer.h"
+#include "Simulation.h"
+#include "VecEnv.h"
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Raquete "automatica": segue a bola mais baixa da tela
+static void TrackLowestBall(const Simulation& sim, SimInput& input)
+{
+	for (int p = 0; p < max_paddles; p++) {
+		input.paddleDir[p] = 0;
+	}
+	const BallStore& balls = sim.vBall;
+	if (sim.vPaddle.empty() || balls.Empty()) return;
+
+	size_t lowest = 0;
+	for (size_t i = 1; i < balls.Size(); i++) {
+		if (balls.posY[i] > balls.posY[lowest]) lowest = i;
+	}
+
+	const Paddle& paddle = sim.vPaddle[0];
+	float target = balls.posX[lowest] + thickness / 2.0f;
+	float center = paddle.pos.x + paddle.width / 2.0f;
+
+	if (target < center - 1.0f) input.paddleDir[0] = -1;
+	else if (target > center + 1.0f) input.paddleDir[0] = 1;
+}
+
+static int Usage(const char* name)
+{
+	fprintf(stderr, "uso: %s [--ticks N] [--dt segundos] [--blocks COLUNASxLINHAS]\n"
+		"       [--max-balls N] [--closed-bottom] [--report TICKS]\n"
+		"       [--threads N] [--bench-collide CONSULTAS] [--events]\n"
+		"       [--seed N] [--record ARQUIVO] [--replay ARQUIVO]\n"
+		"       [--diff ARQUIVO1 ARQUIVO2] [--check-threads N]\n"
+		"       [--load-snapshot ARQUIVO] [--save-snapshot ARQUIVO]\n"
+		"       [--bench-clone N] [--envs N] [--pixels LARGURAxALTURA]\n"
+		"       [--rgb] [--frame ARQUIVO] [--shm NOME] [--slots N]\n"
+		"       [--frame-skip K]\n", name);
+	return 1;
+}
+
+// Joga um replay o mais rapido possivel, conferindo o hash de cada tick
+static int PlayReplay(const char* path, int threads)
+{
+	ReplayPlayer player;
+	if (!player.Open(path)) {
+		fprintf(stderr, "replay invalido: %s\n", path);
+		return 1;
+	}
+
+	SimConfig config = player.Config();
+	config.threads = threads;
+	printf("replay: %s\n", path);
+	printf("semente: %llu\n", static_cast<unsigned long long>(config.seed));
+	printf("blocos: %dx%d\n", config.columns, config.rows);
+
+	Simulation sim;
+	sim.Initialize(config);
+
+	SimInput input;
+	uint64_t expected;
+	auto start = std::chrono::steady_clock::now();
+
+	while (player.Next(input, expected)) {
+		sim.Step(player.Step(), input);
+
+		uint64_t hash = sim.Hash();
+		if (hash != expected) {
+			printf("DIVERGIU no tick %ld: hash %016llx, esperado %016llx\n", player.Ticks(),
+				static_cast<unsigned long long>(hash), static_cast<unsigned long long>(expected));
+			return 1;
+		}
+
+		// mesma regra da gravacao: recomeca quando o jogo acaba
+		if (sim.IsOver()) sim.Initialize(config);
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	printf("ticks: %ld, todos conferem\n", player.Ticks());
+	printf("ticks/s: %.0f\n", seconds > 0.0 ? player.Ticks() / seconds : 0.0);
+	return 0;
+}
+
+// Compara dois replays tick a tick (entradas e hash do estado)
+static int DiffReplays(const char* pathA, const char* pathB)
+{
+	ReplayPlayer a, b;
+	if (!a.Open(pathA)) {
+		fprintf(stderr, "replay invalido: %s\n", pathA);
+		return 1;
+	}
+	if (!b.Open(pathB)) {
+		fprintf(stderr, "replay invalido: %s\n", pathB);
+		return 1;
+	}
+
+	const SimConfig& ca = a.Config();
+	const SimConfig& cb = b.Config();
+	if (ca.columns != cb.columns || ca.rows != cb.rows || ca.maxBalls != cb.maxBalls
+		|| ca.closedBottom != cb.closedBottom || ca.seed != cb.seed || a.Step() != b.Step()) {
+		printf("configuracoes diferentes\n");
+		return 1;
+	}
+
+	SimInput inputA, inputB;
+	uint64_t hashA, hashB;
+	for (;;) {
+		bool moreA = a.Next(inputA, hashA);
+		bool moreB = b.Next(inputB, hashB);
+		if (!moreA || !moreB) {
+			if (moreA != moreB) {
+				printf("tamanhos diferentes: %ld e %ld ticks\n",
+					a.Ticks() - moreA, b.Ticks() - moreB);
+				return 1;
+			}
+			break;
+		}
+
+		if (memcmp(inputA.paddleDir, inputB.paddleDir, sizeof(inputA.paddleDir)) != 0) {
+			printf("entradas diferentes no tick %ld\n", a.Ticks());
+			return 1;
+		}
+		if (hashA != hashB) {
+			printf("primeiro tick diferente: %ld (%016llx, %016llx)\n", a.Ticks(),
+				static_cast<unsigned long long>(hashA), static_cast<unsigned long long>(hashB));
+			return 1;
+		}
+	}
+
+	printf("identicos: %ld ticks\n", a.Ticks());
+	return 0;
+}
+
+// Roda o mesmo cenario com 1 e com threads threads, lado a lado,
+// e compara o hash do estado a cada tick
+static int CheckThreads(SimConfig config, int threads, long ticks, float deltaTime)
+{
+	SimConfig single = config;
+	single.threads = 1;
+	config.threads = threads;
+
+	Simulation a, b;
+	a.Initialize(single);
+	b.Initialize(config);
+
+	SimInput input;
+	for (long t = 0; t < ticks; t++) {
+		TrackLowestBall(a, input);
+		a.Step(deltaTime, input);
+		b.Step(deltaTime, input);
+
+		if (a.Hash() != b.Hash()) {
+			printf("1 e %d threads divergem no tick %ld (bolas %zu e %zu)\n",
+				threads, t + 1, a.vBall.Size(), b.vBall.Size());
+			return 1;
+		}
+
+		if (a.IsOver()) {
+			a.Initialize(single);
+			b.Initialize(config);
+		}
+	}
+
+	printf("1 e %d threads identicos em %ld ticks (bolas %zu)\n", threads, ticks, a.vBall.Size());
+	return 0;
+}
+
+// Grava um quadro do Rasterize como PGM (cinza) ou PPM (RGB)
+static bool SaveFrame(const char* path, const RasterConfig& raster, const unsigned char* pixels)
+{
+	FILE* file = fopen(path, "wb");
+	if (!file) return false;
+	fprintf(file, "P%c\n%d %d\n255\n", raster.format == PIXEL_GRAY ? '5' : '6',
+		raster.width, raster.height);
+	bool ok = fwrite(pixels, 1, raster.FrameSize(), file) == raster.FrameSize();
+	return fclose(file) == 0 && ok;
+}
+
+// Avanca count ambientes juntos por ticks passos; com raster, desenha
+// todos a cada passo
+static int RunEnvs(int count, const SimConfig& config, long ticks, float deltaTime,
+	int frameSkip, const RasterConfig* raster, const char* framePath)
+{
+	VecEnv env(count, config, deltaTime, config.threads);
+	env.SetFrameSkip(frameSkip);
+
+	std::vector<float> observations((size_t)count * OBS_SIZE);
+	std::vector<float> rewards(count);
+	std::vector<unsigned char> dones(count);
+	std::vector<int> actions(count);
+	std::vector<unsigned char> pixels;
+	if (raster) pixels.resize(count * raster->FrameSize());
+
+	env.Reset(observations.data());
+
+	long episodes = 0;
+	double totalReward = 0.0;
+	auto start = std::chrono::steady_clock::now();
+
+	for (long t = 0; t < ticks; t++) {
+		// politica de exemplo: raquete atras da bola mais baixa
+		for (int i = 0; i < count; i++) {
+			const float* obs = &observations[(size_t)i * OBS_SIZE];
+			float diff = obs[OBS_BALL_X] - obs[OBS_PADDLE_X];
+			actions[i] = diff < -0.01f ? -1 : (diff > 0.01f ? 1 : 0);
+		}
+
+		env.Step(actions.data(), observations.data(), rewards.data(), dones.data());
+		if (raster) env.Render(*raster, pixels.data());
+
+		for (int i = 0; i < count; i++) {
+			totalReward += rewards[i];
+			episodes += dones[i];
+		}
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double steps = (double)ticks * count;
+	printf("ambientes: %d, passos: %ld\n", count, ticks);
+	printf("partidas terminadas: %ld, recompensa total: %.0f\n", episodes, totalReward);
+	printf("tempo: %.3f s\n", seconds);
+	printf("passos de ambiente/s: %.0f\n", seconds > 0.0 ? steps / seconds : 0.0);
+
+	if (raster && framePath) {
+		if (!SaveFrame(framePath, *raster, pixels.data())) {
+			fprintf(stderr, "nao foi possivel gravar %s\n", framePath);
+			return 1;
+		}
+		printf("quadro salvo em %s\n", framePath);
+	}
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	long ticks = 100000;
+	float deltaTime = 1.0f / 60.0f;
+	SimConfig config;
+	// imprime a contagem de bolas e os ticks/s a cada report ticks
+	long report = 0;
+	long benchQueries = 0;
+	// avanca por eventos em vez de ticks fixos
+	bool events = false;
+	const char* recordPath = nullptr;
+	const char* replayPath = nullptr;
+	const char* diffPaths[2] = { nullptr, nullptr };
+	int checkThreads = 0;
+	const char* loadPath = nullptr;
+	const char* savePath = nullptr;
+	long clones = 0;
+	int envs = 0;
+	RasterConfig raster;
+	bool pixels = false;
+	const char* framePath = nullptr;
+	const char* shmName = nullptr;
+	int slots = 4;
+	int frameSkip = 1;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+			ticks = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc) {
+			deltaTime = (float)atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--blocks") == 0 && i + 1 < argc) {
+			if (sscanf(argv[++i], "%dx%d", &config.columns, &config.rows) != 2
+				|| config.columns <= 0 || config.rows <= 0) {
+				return Usage(argv[0]);
+			}
+		}
+		else if (strcmp(argv[i], "--max-balls") == 0 && i + 1 < argc) {
+			char* end = nullptr;
+			long maxBalls = strtol(argv[++i], &end, 10);
+			if (end == argv[i] || *end != '\0' || maxBalls < 1 || maxBalls > INT_MAX) {
+				return Usage(argv[0]);
+			}
+			config.maxBalls = static_cast<int>(maxBalls);
+		}
+		else if (strcmp(argv[i], "--closed-bottom") == 0) {
+			config.closedBottom = true;
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			config.threads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+			report = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--bench-collide") == 0 && i + 1 < argc) {
+			benchQueries = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--events") == 0) {
+			events = true;
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+			config.seed = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+			recordPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+			replayPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--diff") == 0 && i + 2 < argc) {
+			diffPaths[0] = argv[++i];
+			diffPaths[1] = argv[++i];
+		}
+		else if (strcmp(argv[i], "--check-threads") == 0 && i + 1 < argc) {
+			checkThreads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--load-snapshot") == 0 && i + 1 < argc) {
+			loadPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--save-snapshot") == 0 && i + 1 < argc) {
+			savePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--bench-clone") == 0 && i + 1 < argc) {
+			clones = atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--envs") == 0 && i + 1 < argc) {
+			envs = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--pixels") == 0 && i + 1 < argc) {
+			if (sscanf(argv[++i], "%dx%d", &raster.width, &raster.height) != 2
+				|| raster.width <= 0 || raster.height <= 0) {
+				return Usage(argv[0]);
+			}
+			pixels = true;
+		}
+		else if (strcmp(argv[i], "--rgb") == 0) {
+			raster.format = PIXEL_RGB;
+		}
+		else if (strcmp(argv[i], "--frame") == 0 && i + 1 < argc) {
+			framePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+			shmName = argv[++i];
+		}
+		else if (strcmp(argv[i], "--slots") == 0 && i + 1 < argc) {
+			slots = atoi(argv[++i]);
+			if (slots < 1) return Usage(argv[0]);
+		}
+		else if (strcmp(argv[i], "--frame-skip") == 0 && i + 1 < argc) {
+			frameSkip = atoi(argv[++i]);
+			if (frameSkip < 1) return Usage(argv[0]);
+		}
+		else {
+			return Usage(argv[0]);
+		}
+	}
+
+	if (benchQueries > 0) {
+		return RunCollideBench(config.columns, config.rows, benchQueries);
+	}
+	if (replayPath) {
+		return PlayReplay(replayPath, config.threads);
+	}
+	if (diffPaths[0]) {
+		return DiffReplays(diffPaths[0], diffPaths[1]);
+	}
+	if (checkThreads > 0) {
+		return CheckThreads(config, checkThreads, ticks, deltaTime);
+	}
+	if (shmName) {
+		VecEnv env(envs > 0 ? envs : 1, config, deltaTime, config.threads);
+		env.SetFrameSkip(frameSkip);
+		return ServeSharedEnv(shmName, env, pixels ? &raster : nullptr, slots);
+	}
+	if (envs > 0) {
+		return RunEnvs(envs, config, ticks, deltaTime, frameSkip, pixels ? &raster : nullptr, framePath);
+	}
+	// o modo por eventos nao tem ticks para gravar, e o replay
+	// precisa do hash de cada tick
+	if (recordPath && (events || frameSkip > 1)) {
+		return Usage(argv[0]);
+	}
+	// um replay sempre comeca de uma partida nova
+	if (recordPath && loadPath) {
+		return Usage(argv[0]);
+	}
+
+	printf("kernel de colisao: %s\n", CollideKernelName(GetCollideKernel()));
+	printf("threads: %d\n", config.threads);
+	printf("modo: %s\n", events ? "eventos" : "ticks");
+	printf("semente: %llu\n", static_cast<unsigned long long>(config.seed));
+
+	Simulation sim;
+	sim.Initialize(config);
+	if (loadPath) {
+		if (!sim.LoadSnapshotFile(loadPath)) {
+			fprintf(stderr, "snapshot invalido: %s\n", loadPath);
+			return 1;
+		}
+		// recomecos usam a configuracao do snapshot
+		int threads = config.threads;
+		config = sim.config;
+		config.threads = threads;
+		printf("snapshot: %s (tick %llu, bolas %zu)\n", loadPath,
+			static_cast<unsigned long long>(sim.tick), sim.vBall.Size());
+	}
+
+	ReplayRecorder recorder;
+	if (recordPath && !recorder.Open(recordPath, config, deltaTime)) {
+		fprintf(stderr, "nao foi possivel criar %s\n", recordPath);
+		return 1;
+	}
+
+	SimInput input;
+	long games = 1;
+
+	auto start = std::chrono::steady_clock::now();
+	auto lastReport = start;
+
+	long lastReportTick = 0;
+
+	for (long t = 0; t < ticks;) {
+		// ticks dados nesta decisao (menos que frameSkip se o jogo acabou)
+		long ran = 1;
+		if (events) {
+			sim.AdvanceEvents(deltaTime);
+		}
+		else {
+			TrackLowestBall(sim, input);
+			long repeat = ticks - t < frameSkip ? ticks - t : frameSkip;
+			ran = sim.StepRepeat(deltaTime, input, static_cast<int>(repeat));
+			if (recorder.IsOpen()) recorder.Record(input, sim.Hash());
+		}
+		t += ran;
+
+		// fim de jogo: recomeca para manter a carga constante
+		if (sim.IsOver()) {
+			sim.Initialize(config);
+			games++;
+		}
+
+		if (report > 0 && t / report != (t - ran) / report) {
+			auto now = std::chrono::steady_clock::now();
+			double interval = std::chrono::duration<double>(now - lastReport).count();
+			printf("tick %8ld  bolas %7zu  ticks/s %10.0f\n",
+				t, sim.vBall.Size(), interval > 0.0 ? (t - lastReportTick) / interval : 0.0);
+			lastReport = now;
+			lastReportTick = t;
+		}
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	printf("blocos: %dx%d\n", config.columns, config.rows);
+	printf("ticks: %ld\n", ticks);
+	printf("jogos: %ld\n", games);
+	printf("tempo: %.3f s\n", seconds);
+	printf("ticks/s: %.0f\n", seconds > 0.0 ? ticks / seconds : 0.0);
+	printf("tempo simulado/s: %.1f\n", seconds > 0.0 ? ticks * deltaTime / seconds : 0.0);
+	printf("hash: %016llx\n", static_cast<unsigned long long>(sim.Hash()));
+
+	if (savePath) {
+		if (!sim.SaveSnapshotFile(savePath)) {
+			fprintf(stderr, "nao foi possivel salvar %s\n", savePath);
+			return 1;
+		}
+		printf("snapshot salvo: %s\n", savePath);
+	}
+
+	if (clones > 0) {
+		std::vector<unsigned char> buffer;
+		sim.SaveSnapshot(buffer);
+
+		// a primeira copia aloca; as seguintes so copiam
+		Simulation copy;
+		copy.CopyFrom(sim);
+		auto cloneStart = std::chrono::steady_clock::now();
+		for (long c = 0; c < clones; c++) copy.CopyFrom(sim);
+		double cloneSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - cloneStart).count();
+
+		printf("snapshot: %zu bytes, bolas %zu\n", buffer.size(), sim.vBall.Size());
+		printf("copias: %ld, %.3f us cada, %.0f copias/s\n", clones,
+			cloneSeconds / clones * 1e6, cloneSeconds > 0.0 ? clones / cloneSeconds : 0.0);
+	}
+
+	return 0;
+}
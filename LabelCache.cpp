@@ -0,0 +1,144 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "LabelCache.h"
+
+// frames sem aparecer ate um label ser descartado (10 s a 60 fps)
+const unsigned long stale_frames = 600;
+
+static bool SameColor(SDL_Color a, SDL_Color b)
+{
+	return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+LabelCache::LabelCache(size_t maxBytes)
+	:mMaxBytes(maxBytes)
+	,mBytes(0)
+	,mFrame(0)
+	,mComposed(0)
+{
+}
+
+LabelCache::~LabelCache()
+{
+	Clear();
+}
+
+void LabelCache::Release(Label& label)
+{
+	if (label.texture) {
+		SDL_DestroyTexture(label.texture);
+		mBytes -= (size_t)label.w * label.h * 4;
+	}
+	label.texture = nullptr;
+	label.w = 0;
+	label.h = 0;
+}
+
+void LabelCache::MakeRoom(size_t bytes, int key)
+{
+	while (mBytes + bytes > mMaxBytes) {
+		// o usado ha mais tempo, fora o proprio e os deste frame
+		auto oldest = mLabels.end();
+		for (auto it = mLabels.begin(); it != mLabels.end(); ++it) {
+			if (it->first == key || !it->second.texture || it->second.frame == mFrame) continue;
+			if (oldest == mLabels.end() || it->second.frame < oldest->second.frame) oldest = it;
+		}
+		if (oldest == mLabels.end()) return;
+		Release(oldest->second);
+		mLabels.erase(oldest);
+	}
+}
+
+void LabelCache::Update(SDL_Renderer* renderer, const TextAtlas& atlas, int key,
+	const char* text, SDL_Color color)
+{
+	Label& label = mLabels[key];
+	label.frame = mFrame;
+
+	// texto ou cor diferentes: monta de novo (uma vez so, mesmo que nao
+	// de certo; sem textura o label sai direto do atlas)
+	if (label.composed && label.text == text && SameColor(label.color, color)) return;
+
+	Release(label);
+	label.text = text;
+	label.color = color;
+	label.composed = true;
+	Compose(renderer, atlas, key, label);
+}
+
+void LabelCache::Compose(SDL_Renderer* renderer, const TextAtlas& atlas, int key, Label& label)
+{
+	int w, h;
+	atlas.Measure(label.text.c_str(), w, h);
+	if (!atlas.IsBuilt() || w == 0 || h == 0 || !SDL_RenderTargetSupported(renderer)) return;
+
+	MakeRoom((size_t)w * h * 4, key);
+	label.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+		SDL_TEXTUREACCESS_TARGET, w, h);
+	if (!label.texture)
+	{
+		SDL_Log("Label %d sem textura: %s", key, SDL_GetError());
+		return;
+	}
+	label.w = w;
+	label.h = h;
+	mBytes += (size_t)w * h * 4;
+	mComposed++;
+
+	// glifos opacos na cor do label sobre fundo transparente; o alfa da
+	// cor so entra no desenho, para nao ser aplicado duas vezes
+	SDL_Color opaque = label.color;
+	opaque.a = 255;
+	SDL_Texture* target = SDL_GetRenderTarget(renderer);
+	SDL_SetRenderTarget(renderer, label.texture);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+	atlas.Draw(renderer, label.text.c_str(), 0, 0, opaque);
+	SDL_SetRenderTarget(renderer, target);
+
+	SDL_SetTextureBlendMode(label.texture, SDL_BLENDMODE_BLEND);
+	SDL_SetTextureAlphaMod(label.texture, label.color.a);
+}
+
+int LabelCache::Draw(SDL_Renderer* renderer, const TextAtlas& atlas, int key, int x, int y)
+{
+	auto it = mLabels.find(key);
+	if (it == mLabels.end()) return 0;
+
+	Label& label = it->second;
+	label.frame = mFrame;
+
+	if (label.texture) {
+		SDL_Rect dest = { x, y, label.w, label.h };
+		SDL_RenderCopy(renderer, label.texture, nullptr, &dest);
+		return 1;
+	}
+	// sem textura alvo: glifo por glifo, direto do atlas
+	return atlas.Draw(renderer, label.text.c_str(), x, y, label.color);
+}
+
+void LabelCache::EndFrame()
+{
+	for (auto it = mLabels.begin(); it != mLabels.end();) {
+		if (mFrame - it->second.frame >= stale_frames) {
+			Release(it->second);
+			it = mLabels.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+	mFrame++;
+}
+
+void LabelCache::Clear()
+{
+	for (auto& entry : mLabels) Release(entry.second);
+	mLabels.clear();
+}
@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <string>
+#include <unordered_map>
+
+#include "SDL/SDL.h"
+
+#include "TextAtlas.h"
+
+// Labels do HUD (placar, bolas, ...) com a textura guardada: cada label
+// lembra o ultimo texto e so e montado de novo quando o texto ou a cor
+// mudam. Montar e copiar os glifos do TextAtlas (feito uma vez, no
+// comeco) numa textura alvo do tamanho do label, sem TTF; fora isso,
+// desenhar um label e um SDL_RenderCopy. Sem texturas alvo (ou se a do
+// label nao pode ser criada), ele sai direto do atlas, um glifo por
+// copia, ate o texto ou a cor mudarem.
+//
+// Labels que ficam stale_frames frames sem ser desenhados sao
+// descartados no EndFrame; se as texturas passarem de maxBytes, os
+// labels usados ha mais tempo saem primeiro.
+class LabelCache
+{
+public:
+	explicit LabelCache(size_t maxBytes = 1 << 20);
+	~LabelCache();
+
+	LabelCache(const LabelCache&) = delete;
+	LabelCache& operator=(const LabelCache&) = delete;
+
+	// Guarda text e color no label key e, se mudaram, monta a textura
+	// de novo. Troca o alvo do renderizador: chame antes de comecar a
+	// desenhar o frame no back buffer.
+	void Update(SDL_Renderer* renderer, const TextAtlas& atlas, int key,
+		const char* text, SDL_Color color);
+	// Desenha o label key (do ultimo Update) com o canto de cima a
+	// esquerda em (x, y). Devolve quantas chamadas de desenho fez.
+	int Draw(SDL_Renderer* renderer, const TextAtlas& atlas, int key, int x, int y);
+	// Fim do frame: descarta os labels que nao aparecem ha muito tempo
+	void EndFrame();
+	// Destroi todas as texturas (antes de destruir o renderizador, ou
+	// quando o driver perde o conteudo das texturas alvo)
+	void Clear();
+
+	size_t Bytes() const { return mBytes; }
+	// vezes que algum label foi montado
+	unsigned long Composed() const { return mComposed; }
+
+private:
+	struct Label
+	{
+		Label(): color(), composed(false), texture(nullptr), w(0), h(0), frame(0) {}
+
+		std::string text;
+		SDL_Color color;
+		// text e color ja foram montados; texture pode ser nullptr mesmo
+		// assim (texto vazio, sem texturas alvo ou falha), e so volta a
+		// tentar quando text ou color mudam
+		bool composed;
+		SDL_Texture* texture;
+		int w;
+		int h;
+		// ultimo frame em que foi desenhado
+		unsigned long frame;
+	};
+
+	// monta a textura de label a partir do atlas
+	void Compose(SDL_Renderer* renderer, const TextAtlas& atlas, int key, Label& label);
+	void Release(Label& label);
+	// tira labels antigos (nunca key nem os do frame atual) ate caber bytes
+	void MakeRoom(size_t bytes, int key);
+
+	std::unordered_map<int, Label> mLabels;
+	size_t mMaxBytes;
+	size_t mBytes;
+	unsigned long mFrame;
+	unsigned long mComposed;
+};
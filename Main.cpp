@@ -7,10 +7,84 @@
 // ----------------------------------------------------------------
 
 #include "Game.h"
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+static int Usage(const char* name)
+{
+	SDL_Log("uso: %s [--fps N] [--max-balls N] [--seed N] [--record ARQUIVO]\n"
+		"       [--replay ARQUIVO] [--gl] [--sprites ARQUIVO] [--flat]", name);
+	return 1;
+}
 
 int main(int argc, char** argv)
 {
 	Game game;
+
+	SimConfig config;
+
+	// --fps N: taxa de frames desejada (0 desliga o limite)
+	// --max-balls N: limite de bolas simultaneas
+	// --seed N: semente dos sorteios (sem ela, uma nova a cada execucao)
+	// --record ARQUIVO: grava a partida num replay
+	// --replay ARQUIVO: joga um replay gravado, em tempo real
+	// --gl: desenha com OpenGL 3.3 (cai para o SDL_Renderer se nao houver)
+	// --sprites ARQUIVO: sprite sheet (JSON) no lugar de Sprites.json
+	// --flat: sem sprites, so cores solidas
+	bool seeded = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+		{
+			game.SetFrameRate(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "--max-balls") == 0 && i + 1 < argc)
+		{
+			char* end = nullptr;
+			long maxBalls = strtol(argv[++i], &end, 10);
+			if (end == argv[i] || *end != '\0' || maxBalls < 1 || maxBalls > INT_MAX)
+			{
+				return Usage(argv[0]);
+			}
+			config.maxBalls = static_cast<int>(maxBalls);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+		{
+			config.seed = strtoull(argv[++i], nullptr, 10);
+			seeded = true;
+		}
+		else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+		{
+			game.SetRecordPath(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+		{
+			game.SetReplayPath(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--gl") == 0)
+		{
+			game.SetUseOpenGL(true);
+		}
+		else if (strcmp(argv[i], "--sprites") == 0 && i + 1 < argc)
+		{
+			game.SetSpritePath(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--flat") == 0)
+		{
+			game.SetSpritePath("");
+		}
+	}
+	// a semente so e sorteada uma vez, aqui; com ela a partida se repete
+	if (!seeded)
+	{
+		std::random_device rd;
+		config.seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+	}
+	SDL_Log("semente: %llu", static_cast<unsigned long long>(config.seed));
+	game.SetSimConfig(config);
+
 	bool success = game.Initialize();
 	if (success)
 	{
@@ -0,0 +1,65 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+
+// Fluxos independentes do gerador: cada uso tem o seu, para que
+// sortear numa parte do jogo nao mude a sequencia das outras
+enum RandomStream
+{
+	STREAM_SPLIT,   // variacao da velocidade das bolas que se dividem
+	STREAM_GAME     // livre para outros usos
+};
+
+// Gerador PCG32 (O'Neill, pcg-random.org): 16 bytes de estado, uma
+// multiplicacao por numero. A mesma semente e o mesmo fluxo dao sempre
+// a mesma sequencia, em qualquer plataforma.
+class Random
+{
+public:
+	Random(uint64_t seed = 0, uint64_t stream = 0)
+	{
+		Seed(seed, stream);
+	}
+
+	void Seed(uint64_t seed, uint64_t stream)
+	{
+		state = 0;
+		inc = (stream << 1) | 1u;
+		Next();
+		state += seed;
+		Next();
+	}
+
+	// proximo numero de 32 bits
+	uint32_t Next()
+	{
+		uint64_t old = state;
+		state = old * 6364136223846793005ULL + inc;
+		uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+		uint32_t rot = static_cast<uint32_t>(old >> 59);
+		return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+	}
+
+	// uniforme em [0, 1)
+	float Float()
+	{
+		// 24 bits: todos os valores sao representaveis em float
+		return (Next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// uniforme em [lo, hi)
+	float Uniform(float lo, float hi)
+	{
+		return lo + (hi - lo) * Float();
+	}
+
+	uint64_t state;
+	uint64_t inc;
+};
@@ -0,0 +1,191 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "Rasterizer.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RASTER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+struct Color
+{
+	unsigned char r, g, b;
+};
+
+// as cores solidas do SdlSceneRenderer e do GlSceneRenderer (sem sprites)
+static const Color background_color = { 0, 0, 255 };
+static const Color wall_color = { 255, 255, 255 };
+static const Color paddle_color = { 0, 255, 0 };
+static const Color ball_color = { 255, 0, 0 };
+static const Color block_color = { 255, 255, 0 };
+
+static float lerp(float a, float b, float t)
+{
+	return a + (b - a) * t;
+}
+
+static unsigned char Gray(Color c)
+{
+	// pesos BT.601 em ponto fixo (somam 256)
+	return static_cast<unsigned char>((77 * c.r + 150 * c.g + 29 * c.b) >> 8);
+}
+
+// Preenche n pixels de um byte com v
+static void FillGray(unsigned char* p, int n, unsigned char v)
+{
+#ifdef RASTER_SSE2
+	__m128i c = _mm_set1_epi8(static_cast<char>(v));
+	for (; n >= 16; n -= 16, p += 16) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(p), c);
+	}
+#endif
+	for (; n > 0; n--) *p++ = v;
+}
+
+// Preenche n pixels RGB com c
+static void FillRGB(unsigned char* p, int n, Color c)
+{
+#ifdef RASTER_SSE2
+	// 16 pixels ocupam 48 bytes: 3 registradores com o padrao RGB
+	if (n >= 16) {
+		unsigned char pattern[48];
+		for (int i = 0; i < 48; i += 3) {
+			pattern[i] = c.r;
+			pattern[i + 1] = c.g;
+			pattern[i + 2] = c.b;
+		}
+		__m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern));
+		__m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern + 16));
+		__m128i c2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern + 32));
+		for (; n >= 16; n -= 16, p += 48) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(p), c0);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(p + 16), c1);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(p + 32), c2);
+		}
+	}
+#endif
+	for (; n > 0; n--, p += 3) {
+		p[0] = c.r;
+		p[1] = c.g;
+		p[2] = c.b;
+	}
+}
+
+// Primeiro pixel cujo centro fica em v ou depois
+static int PixelStart(float v)
+{
+	return static_cast<int>(std::ceil(v - 0.5f));
+}
+
+static int ClampPixel(int v, int size)
+{
+	return v < 0 ? 0 : (v > size ? size : v);
+}
+
+class Canvas
+{
+public:
+	Canvas(const RasterConfig& raster, unsigned char* pixels)
+		:raster(raster)
+		,pixels(pixels)
+		,scaleX(static_cast<float>(raster.width) / SCREEN_WIDTH)
+		,scaleY(static_cast<float>(raster.height) / SCREEN_HEIGHT)
+	{
+	}
+
+	void SetColor(Color c)
+	{
+		color = c;
+		gray = Gray(c);
+	}
+
+	void Clear()
+	{
+		Span(pixels, raster.width * raster.height);
+	}
+
+	// Mesmo retangulo que o SDL_RenderFillRect recebe no jogo
+	void FillRect(int x, int y, int w, int h)
+	{
+		if (w <= 0 || h <= 0) return;
+
+		int x0 = ClampPixel(PixelStart(x * scaleX), raster.width);
+		int x1 = ClampPixel(PixelStart((x + w) * scaleX), raster.width);
+		int y0 = ClampPixel(PixelStart(y * scaleY), raster.height);
+		int y1 = ClampPixel(PixelStart((y + h) * scaleY), raster.height);
+		if (x0 >= x1) return;
+
+		size_t stride = (size_t)raster.width * raster.format;
+		for (int row = y0; row < y1; row++) {
+			Span(pixels + row * stride + (size_t)x0 * raster.format, x1 - x0);
+		}
+	}
+
+private:
+	void Span(unsigned char* p, int n)
+	{
+		if (raster.format == PIXEL_GRAY) FillGray(p, n, gray);
+		else FillRGB(p, n, color);
+	}
+
+	const RasterConfig& raster;
+	unsigned char* pixels;
+	float scaleX;
+	float scaleY;
+	Color color;
+	unsigned char gray;
+};
+
+void Rasterize(const Simulation& sim, const RasterConfig& raster,
+	unsigned char* pixels, float alpha)
+{
+	Canvas canvas(raster, pixels);
+
+	canvas.SetColor(background_color);
+	canvas.Clear();
+
+	// paredes de cima, da direita e da esquerda (a de baixo nao e desenhada)
+	canvas.SetColor(wall_color);
+	canvas.FillRect(0, 0, SCREEN_WIDTH, thickness);
+	canvas.FillRect(SCREEN_WIDTH - thickness, 0, thickness, SCREEN_WIDTH);
+	canvas.FillRect(0, 0, thickness, SCREEN_WIDTH);
+
+	// blocos antes de raquetes e bolas, como nos renderizadores (que
+	// guardam paredes e blocos numa camada por baixo do resto)
+	canvas.SetColor(block_color);
+	for (Block const& block : sim.vBlock) {
+		if (!block.onScreen) continue;
+		canvas.FillRect(
+			static_cast<int>(block.pos.x),
+			static_cast<int>(block.pos.y),
+			static_cast<int>(block.width),
+			static_cast<int>(block.height));
+	}
+
+	canvas.SetColor(paddle_color);
+	for (auto const& paddle : sim.vPaddle) {
+		if (!paddle.onScreen) continue;
+		canvas.FillRect(
+			static_cast<int>(lerp(paddle.prev.x, paddle.pos.x, alpha)),
+			static_cast<int>(lerp(paddle.prev.y, paddle.pos.y, alpha)),
+			static_cast<int>(paddle.width),
+			static_cast<int>(paddle.height));
+	}
+
+	canvas.SetColor(ball_color);
+	const BallStore& balls = sim.vBall;
+	for (size_t i = 0; i < balls.Size(); i++) {
+		canvas.FillRect(
+			static_cast<int>(lerp(balls.prevX[i], balls.posX[i], alpha)),
+			static_cast<int>(lerp(balls.prevY[i], balls.posY[i], alpha)),
+			thickness,
+			thickness);
+	}
+}
@@ -0,0 +1,47 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+
+#include "Simulation.h"
+
+// Observacao em pixels sem SDL: desenha a mesma cena dos SceneRenderer
+// do jogo (fundo, paredes, blocos, raquetes e bolas, nessa ordem, a de
+// Scene) com as cores solidas deles num buffer de bytes do chamador, ja
+// na resolucao pedida. O HUD fica de fora.
+//
+// Os retangulos sao os mesmos SDL_Rect inteiros de BuildScene,
+// escalados de SCREEN_WIDTH x SCREEN_HEIGHT para width x height; um pixel
+// e pintado quando o seu centro cai dentro do retangulo escalado, a regra
+// do SDL com SDL_RenderSetScale. Em 640x480 o resultado e igual, pixel a
+// pixel, ao da janela com --flat (sem sprites), fora o texto do HUD.
+
+// bytes por pixel
+enum PixelFormat
+{
+	PIXEL_GRAY = 1,    // luminancia (BT.601)
+	PIXEL_RGB = 3
+};
+
+struct RasterConfig
+{
+	int width;
+	int height;
+	PixelFormat format;
+
+	RasterConfig(): width(84), height(84), format(PIXEL_GRAY) {}
+
+	// bytes de um quadro (linhas contiguas, sem preenchimento)
+	size_t FrameSize() const { return (size_t)width * height * format; }
+};
+
+// Desenha sim em pixels (raster.FrameSize() bytes). alpha interpola
+// raquetes e bolas entre a posicao anterior e a atual, como no jogo.
+void Rasterize(const Simulation& sim, const RasterConfig& raster,
+	unsigned char* pixels, float alpha = 1.0f);
@@ -0,0 +1,159 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "Replay.h"
+#include "BinaryIO.h"
+#include <cstring>
+
+static const char replay_magic[4] = { 'A', 'R', 'K', 'R' };
+
+// bytes por tick: uma direcao por raquete e o hash
+const size_t replay_tick_size = max_paddles + 8;
+
+// cabecalho: magica, versao, passo, colunas, linhas, maxBalls,
+// closedBottom, numero de raquetes, 2 bytes livres, semente
+const size_t replay_header_size = 4 + 4 + 4 + 4 + 4 + 4 + 1 + 1 + 2 + 8;
+
+// limites da configuracao num replay: um arquivo corrompido (ou feito
+// de proposito) nao pode pedir um mapa ou uma reserva de bolas que o
+// Simulation::Initialize nem consegue alocar
+const int max_replay_blocks = 1 << 20;
+const int max_replay_balls = 1 << 24;
+
+static bool ValidConfig(const SimConfig& config)
+{
+	return config.columns > 0 && config.rows > 0
+		&& config.columns <= max_replay_blocks / config.rows
+		&& config.maxBalls >= 1 && config.maxBalls <= max_replay_balls;
+}
+
+ReplayRecorder::ReplayRecorder()
+	:file(nullptr)
+	,ticks(0)
+{
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+	Close();
+}
+
+bool ReplayRecorder::Open(const char* path, const SimConfig& config, float step)
+{
+	Close();
+	// o que nao poderia ser jogado de volta nem e gravado
+	if (!ValidConfig(config)) return false;
+	file = fopen(path, "wb");
+	if (!file) return false;
+
+	unsigned char header[replay_header_size] = { 0 };
+
+	memcpy(header, replay_magic, 4);
+	PutU32(header + 4, replay_version);
+	PutU32(header + 8, FloatBits(step));
+	PutU32(header + 12, static_cast<uint32_t>(config.columns));
+	PutU32(header + 16, static_cast<uint32_t>(config.rows));
+	PutU32(header + 20, static_cast<uint32_t>(config.maxBalls));
+	header[24] = config.closedBottom ? 1 : 0;
+	header[25] = max_paddles;
+	PutU64(header + 28, config.seed);
+
+	ticks = 0;
+	if (fwrite(header, sizeof(header), 1, file) != 1) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void ReplayRecorder::Record(const SimInput& input, uint64_t hash)
+{
+	if (!file) return;
+
+	unsigned char record[replay_tick_size];
+	for (int p = 0; p < max_paddles; p++) {
+		record[p] = static_cast<unsigned char>(static_cast<signed char>(input.paddleDir[p]));
+	}
+	PutU64(record + max_paddles, hash);
+
+	fwrite(record, sizeof(record), 1, file);
+	ticks++;
+}
+
+void ReplayRecorder::Close()
+{
+	if (file) fclose(file);
+	file = nullptr;
+}
+
+ReplayPlayer::ReplayPlayer()
+	:file(nullptr)
+	,step(0.0f)
+	,ticks(0)
+{
+}
+
+ReplayPlayer::~ReplayPlayer()
+{
+	Close();
+}
+
+bool ReplayPlayer::Open(const char* path)
+{
+	Close();
+	file = fopen(path, "rb");
+	if (!file) return false;
+
+	unsigned char header[replay_header_size];
+	if (fread(header, sizeof(header), 1, file) != 1
+		|| memcmp(header, replay_magic, 4) != 0
+		|| GetU32(header + 4) != replay_version
+		|| header[25] != max_paddles) {
+		Close();
+		return false;
+	}
+
+	step = BitsFloat(GetU32(header + 8));
+
+	config = SimConfig();
+	config.columns = static_cast<int>(GetU32(header + 12));
+	config.rows = static_cast<int>(GetU32(header + 16));
+	config.maxBalls = static_cast<int>(GetU32(header + 20));
+	config.closedBottom = header[24] != 0;
+	config.seed = GetU64(header + 28);
+
+	// valores acima de INT_MAX ja viraram negativos acima
+	if (!ValidConfig(config) || !(step > 0.0f)) {
+		Close();
+		return false;
+	}
+
+	ticks = 0;
+	return true;
+}
+
+bool ReplayPlayer::Next(SimInput& input, uint64_t& hash)
+{
+	if (!file) return false;
+
+	unsigned char record[replay_tick_size];
+	if (fread(record, sizeof(record), 1, file) != 1) return false;
+
+	for (int p = 0; p < max_paddles; p++) {
+		input.paddleDir[p] = static_cast<signed char>(record[p]);
+	}
+	hash = GetU64(record + max_paddles);
+	ticks++;
+	return true;
+}
+
+void ReplayPlayer::Close()
+{
+	if (file) fclose(file);
+	file = nullptr;
+}
@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+#include "Simulation.h"
+
+// Arquivo de replay (binario, little-endian):
+//   cabecalho: "ARKR", versao, passo fixo da simulacao e a SimConfig
+//   (colunas, linhas, maxBalls, closedBottom, semente)
+//   um registro por tick: direcao de cada raquete (1 byte cada) e o
+//   hash do estado depois do tick (Simulation::Hash)
+// Como a simulacao e deterministica, semente + configuracao + entradas
+// bastam para refazer a partida; o hash mostra onde ela divergiu.
+
+// versao 2: hash de Simulation::Hash por palavras (incremental nos blocos)
+const uint32_t replay_version = 2;
+
+// Grava um replay tick a tick
+class ReplayRecorder
+{
+public:
+	ReplayRecorder();
+	~ReplayRecorder();
+
+	ReplayRecorder(const ReplayRecorder&) = delete;
+	ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+	// Cria o arquivo e grava o cabecalho; false se nao conseguiu ou se a
+	// configuracao passa dos limites que o ReplayPlayer aceita
+	bool Open(const char* path, const SimConfig& config, float step);
+	// Grava a entrada usada num tick e o hash do estado depois dele
+	void Record(const SimInput& input, uint64_t hash);
+	void Close();
+
+	bool IsOpen() const { return file != nullptr; }
+	long Ticks() const { return ticks; }
+
+private:
+	FILE* file;
+	long ticks;
+};
+
+// Le um replay gravado pelo ReplayRecorder
+class ReplayPlayer
+{
+public:
+	ReplayPlayer();
+	~ReplayPlayer();
+
+	ReplayPlayer(const ReplayPlayer&) = delete;
+	ReplayPlayer& operator=(const ReplayPlayer&) = delete;
+
+	// Abre o arquivo e le o cabecalho; false se nao e um replay valido
+	bool Open(const char* path);
+	// Proximo tick: entrada a aplicar e hash esperado depois do Step;
+	// false no fim do arquivo
+	bool Next(SimInput& input, uint64_t& hash);
+	void Close();
+
+	bool IsOpen() const { return file != nullptr; }
+	// configuracao e passo gravados no cabecalho
+	const SimConfig& Config() const { return config; }
+	float Step() const { return step; }
+	long Ticks() const { return ticks; }
+
+private:
+	FILE* file;
+	SimConfig config;
+	float step;
+	long ticks;
+};
@@ -0,0 +1,131 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "Scene.h"
+
+static float lerp(float a, float b, float t)
+{
+	return a + (b - a) * t;
+}
+
+Scene::Scene()
+	:blockVersion(0)
+	,blocksVisible(0)
+{
+	// paredes de cima, da direita e da esquerda (a de baixo fica aberta)
+	walls.push_back({ 0, 0, SCREEN_WIDTH, thickness });
+	walls.push_back({ SCREEN_WIDTH - thickness, 0, thickness, SCREEN_WIDTH });
+	walls.push_back({ 0, 0, thickness, SCREEN_WIDTH });
+
+	// o HUD fica logo abaixo dos blocos
+	int x = thickness + 5;
+	int y = SCREEN_HEIGHT / 3 + 5;
+	const int offsets[HUD_LABELS] = { 0, 220, 380 };
+	for (int k = 0; k < HUD_LABELS; k++) {
+		hud[k].x = x + offsets[k];
+		hud[k].y = y;
+		hud[k].text[0] = '\0';
+	}
+}
+
+void Scene::Reserve(const SimConfig& config, size_t blockCount)
+{
+	blocks.reserve(blockCount);
+	paddles.reserve(max_paddles);
+	balls.reserve(config.maxBalls);
+}
+
+void BuildScene(const Simulation& sim, float alpha, Scene& scene)
+{
+	if (scene.blockVersion != sim.blockVersion || scene.blocks.size() != sim.vBlock.size()) {
+		scene.blocks.resize(sim.vBlock.size());
+		scene.blocksVisible = 0;
+		for (size_t k = 0; k < sim.vBlock.size(); k++) {
+			const Block& block = sim.vBlock[k];
+			SceneBlock& out = scene.blocks[k];
+			out.rect = SDL_Rect{
+				static_cast<int>(block.pos.x),
+				static_cast<int>(block.pos.y),
+				static_cast<int>(block.width),
+				static_cast<int>(block.height)
+			};
+			out.taps = block.taps;
+			out.visible = block.onScreen;
+			if (block.onScreen) scene.blocksVisible++;
+		}
+		scene.blockVersion = sim.blockVersion;
+	}
+
+	scene.paddles.clear();
+	for (auto const& paddle : sim.vPaddle) {
+		if (paddle.onScreen) {
+			scene.paddles.push_back({
+				// static_cast converte de float para inteiros,
+				// pois SDL_Rect trabalha com inteiros
+				static_cast<int>(lerp(paddle.prev.x, paddle.pos.x, alpha)),
+				static_cast<int>(lerp(paddle.prev.y, paddle.pos.y, alpha)),
+				static_cast<int>(paddle.width),
+				static_cast<int>(paddle.height)
+			});
+		}
+	}
+
+	scene.balls.clear();
+	const BallStore& balls = sim.vBall;
+	for (size_t i = 0; i < balls.Size(); i++) {
+		scene.balls.push_back({
+			static_cast<int>(lerp(balls.prevX[i], balls.posX[i], alpha)),
+			static_cast<int>(lerp(balls.prevY[i], balls.posY[i], alpha)),
+			thickness,
+			thickness
+		});
+	}
+
+	SDL_snprintf(scene.hud[HUD_GOALS].text, sizeof(scene.hud[HUD_GOALS].text),
+		"Gols sofridos: %3d", sim.goals.empty() ? 0 : sim.goals[0]);
+	SDL_snprintf(scene.hud[HUD_BALLS].text, sizeof(scene.hud[HUD_BALLS].text),
+		"Bolas: %d", static_cast<int>(balls.Size()));
+	SDL_snprintf(scene.hud[HUD_BLOCKS].text, sizeof(scene.hud[HUD_BLOCKS].text),
+		"Blocos: %d", sim.blocksAlive);
+}
+
+SceneSnapshot::SceneSnapshot()
+	:time(0)
+	,tick(0)
+{
+}
+
+// from e to vem do mesmo tick, entao tem os mesmos objetos na mesma ordem
+static void LerpRects(const std::vector<SDL_Rect>& from, const std::vector<SDL_Rect>& to,
+	float alpha, std::vector<SDL_Rect>& out)
+{
+	out.resize(to.size());
+	for (size_t i = 0; i < to.size(); i++) {
+		out[i] = to[i];
+		out[i].x = static_cast<int>(lerp(static_cast<float>(from[i].x), static_cast<float>(to[i].x), alpha));
+		out[i].y = static_cast<int>(lerp(static_cast<float>(from[i].y), static_cast<float>(to[i].y), alpha));
+	}
+}
+
+void LerpScene(const SceneSnapshot& snapshot, float alpha, Scene& scene)
+{
+	const Scene& to = snapshot.to;
+	if (scene.blockVersion != to.blockVersion || scene.blocks.size() != to.blocks.size()) {
+		// assign reaproveita a memoria que scene.blocks ja tem
+		scene.blocks.assign(to.blocks.begin(), to.blocks.end());
+		scene.blocksVisible = to.blocksVisible;
+		scene.blockVersion = to.blockVersion;
+	}
+
+	LerpRects(snapshot.from.paddles, to.paddles, alpha, scene.paddles);
+	LerpRects(snapshot.from.balls, to.balls, alpha, scene.balls);
+
+	for (int k = 0; k < HUD_LABELS; k++) {
+		scene.hud[k] = to.hud[k];
+	}
+}
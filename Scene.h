@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <vector>
+
+#include "SDL/SDL.h"
+#include "Simulation.h"
+
+// chaves dos labels do HUD
+enum HudLabel
+{
+	HUD_GOALS,
+	HUD_BALLS,
+	HUD_BLOCKS,
+	HUD_LABELS
+};
+
+// Um label do HUD ja formatado
+struct HudText
+{
+	int x;
+	int y;
+	char text[32];
+};
+
+// Um bloco do mapa, na ordem de Simulation::vBlock
+struct SceneBlock
+{
+	SDL_Rect rect;
+	// batidas que o bloco ja levou (Block::taps)
+	int taps;
+	bool visible;
+};
+
+// Tudo o que um SceneRenderer precisa para desenhar um frame, ja em
+// pixels (os mesmos SDL_Rect inteiros de sempre): paredes, blocos,
+// raquetes e bolas, nessa ordem, e o HUD por cima.
+struct Scene
+{
+	Scene();
+
+	// espaco para o pior caso, para nao alocar durante o jogo
+	void Reserve(const SimConfig& config, size_t blockCount);
+
+	std::vector<SDL_Rect> walls;
+	std::vector<SceneBlock> blocks;
+	// Simulation::blockVersion de quando blocks foi preenchido
+	uint64_t blockVersion;
+	// quantos blocks estao visiveis
+	int blocksVisible;
+	std::vector<SDL_Rect> paddles;
+	std::vector<SDL_Rect> balls;
+	HudText hud[HUD_LABELS];
+};
+
+// Preenche scene com o estado de sim, raquetes e bolas interpoladas com
+// alpha. Os blocos so sao refeitos quando blockVersion muda, entao o
+// custo por frame nao depende do tamanho do mapa.
+void BuildScene(const Simulation& sim, float alpha, Scene& scene);
+
+// Estado publicado pela thread da simulacao para a do desenho: a cena
+// do tick anterior (alpha 0) e a do ultimo tick (alpha 1), e quando
+// esse tick terminou (SDL_GetPerformanceCounter). Quem desenha
+// interpola entre as duas pelo tempo que passou desde time.
+struct SceneSnapshot
+{
+	SceneSnapshot();
+
+	Scene from;
+	Scene to;
+	Uint64 time;
+	// Simulation::tick de to
+	uint64_t tick;
+};
+
+// Preenche scene com snapshot interpolado com alpha: raquetes e bolas
+// entre from e to, blocos e HUD de to (os blocos so quando mudam).
+void LerpScene(const SceneSnapshot& snapshot, float alpha, Scene& scene);
@@ -0,0 +1,31 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include "SDL/SDL.h"
+
+#include "Scene.h"
+
+// Desenha uma Scene na janela. O Game so conhece esta interface:
+// SdlSceneRenderer (SDL_Renderer, sempre disponivel) e GlSceneRenderer
+// (OpenGL 3.3 com instancing, opcional).
+class SceneRenderer
+{
+public:
+	virtual ~SceneRenderer() {}
+
+	// nome para o log
+	virtual const char* Name() const = 0;
+	// Desenha scene e troca os buffers. Devolve quantas chamadas de
+	// desenho fez.
+	virtual int Render(const Scene& scene) = 0;
+	// Eventos da janela que interessam ao renderizador (texturas perdidas, ...)
+	virtual void HandleEvent(const SDL_Event& event) { (void)event; }
+	// Resumo do Shutdown, depois de frames frames
+	virtual void LogStats(unsigned long long frames) const { (void)frames; }
+};
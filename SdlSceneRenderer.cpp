@@ -0,0 +1,291 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "SdlSceneRenderer.h"
+
+SdlSceneRenderer::SdlSceneRenderer()
+	:mRenderer(nullptr)
+	,mSheet(nullptr)
+	,mSprites(nullptr)
+	,mStaticLayer(nullptr)
+	,mStaticVersion(0)
+	,mStaticDirty(true)
+	,mDrawCalls(0)
+{
+}
+
+SdlSceneRenderer::~SdlSceneRenderer()
+{
+	// as texturas antes do renderizador
+	mHud.Clear();
+	mText.Destroy();
+	if (mStaticLayer) SDL_DestroyTexture(mStaticLayer);
+	if (mSprites) SDL_DestroyTexture(mSprites);
+	if (mRenderer) SDL_DestroyRenderer(mRenderer);
+}
+
+bool SdlSceneRenderer::Initialize(SDL_Window* window, TTF_Font* font, const SpriteSheet& sprites)
+{
+	//// Create SDL renderer
+	mRenderer = SDL_CreateRenderer(
+		window, // Window to create renderer for
+		-1,		 // Usually -1
+		SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
+	);
+
+	if (!mRenderer)
+	{
+		SDL_Log("Failed to create renderer: %s", SDL_GetError());
+		return false;
+	}
+
+	// o unico uso da fonte: depois disso o texto sai todo do atlas
+	if (!mText.Build(mRenderer, font))
+	{
+		SDL_Log("Sem atlas de texto: HUD desligado");
+	}
+	if (sprites.IsLoaded())
+	{
+		mSheet = &sprites;
+		CreateSpriteTexture();
+	}
+	CreateStaticLayer();
+	return true;
+}
+
+void SdlSceneRenderer::CreateSpriteTexture()
+{
+	// os pixels do SOIL sao bytes R, G, B, A
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+	Uint32 format = SDL_PIXELFORMAT_RGBA8888;
+#else
+	Uint32 format = SDL_PIXELFORMAT_ABGR8888;
+#endif
+	mSprites = SDL_CreateTexture(mRenderer, format, SDL_TEXTUREACCESS_STATIC,
+		mSheet->Width(), mSheet->Height());
+	if (!mSprites || SDL_UpdateTexture(mSprites, nullptr, mSheet->Pixels(), mSheet->Width() * 4) != 0)
+	{
+		SDL_Log("Failed to create sprite texture: %s", SDL_GetError());
+		if (mSprites) SDL_DestroyTexture(mSprites);
+		mSprites = nullptr;
+		mSheet = nullptr;
+		return;
+	}
+	SDL_SetTextureBlendMode(mSprites, SDL_BLENDMODE_BLEND);
+}
+
+int SdlSceneRenderer::BlockLook(const SceneBlock& block) const
+{
+	if (!block.visible) return 0;
+	// com sprites, cada batida pode trocar o desenho do bloco
+	return mSprites ? 1 + mSheet->Block(block.taps) : 1;
+}
+
+void SdlSceneRenderer::HandleEvent(const SDL_Event& event)
+{
+	// o driver perdeu o conteudo das texturas alvo
+	if (event.type == SDL_RENDER_TARGETS_RESET)
+	{
+		mStaticDirty = true;
+		// os labels tambem sao texturas alvo; voltam no proximo frame
+		mHud.Clear();
+	}
+}
+
+void SdlSceneRenderer::CreateStaticLayer()
+{
+	if (mStaticLayer)
+	{
+		SDL_DestroyTexture(mStaticLayer);
+		mStaticLayer = nullptr;
+	}
+	if (SDL_RenderTargetSupported(mRenderer))
+	{
+		mStaticLayer = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_RGBA8888,
+			SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+	}
+	if (!mStaticLayer)
+	{
+		SDL_Log("Sem textura alvo: paredes e blocos desenhados a cada frame");
+	}
+	mStaticDirty = true;
+}
+
+void SdlSceneRenderer::DrawStaticLayer(const Scene& scene, const SDL_Rect& region)
+{
+	// so os blocos que tocam a regiao
+	mBlockRects.clear();
+	mBlockSprites.clear();
+	for (SceneBlock const &block : scene.blocks) {
+		if (block.visible && SDL_HasIntersection(&block.rect, &region)) {
+			mBlockRects.push_back(block.rect);
+			if (mSprites) mBlockSprites.push_back(mSheet->Block(block.taps));
+		}
+	}
+
+	if (mSprites)
+	{
+		CopyLayer(scene.walls, mSheet->Wall());
+		for (size_t k = 0; k < mBlockRects.size(); k++) {
+			SDL_RenderCopy(mRenderer, mSprites, &mSheet->Rect(mBlockSprites[k]), &mBlockRects[k]);
+		}
+		mDrawCalls += static_cast<int>(mBlockRects.size());
+		return;
+	}
+
+	// paredes brancas e blocos amarelos
+	FillLayer(scene.walls, 255, 255, 255);
+	FillLayer(mBlockRects, 255, 255, 0);
+}
+
+void SdlSceneRenderer::UpdateStaticLayer(const Scene& scene)
+{
+	if (!mStaticDirty && scene.blockVersion == mStaticVersion) return;
+	mStaticVersion = scene.blockVersion;
+
+	SDL_Rect region = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+	if (mStaticDirty || mStaticBlocks.size() != scene.blocks.size())
+	{
+		mStaticBlocks.resize(scene.blocks.size());
+		for (size_t k = 0; k < scene.blocks.size(); k++) {
+			mStaticBlocks[k] = BlockLook(scene.blocks[k]);
+		}
+	}
+	else
+	{
+		// refaz so a regiao dos blocos que mudaram desde o ultimo desenho
+		bool changed = false;
+		for (size_t k = 0; k < scene.blocks.size(); k++) {
+			int look = BlockLook(scene.blocks[k]);
+			if (look == mStaticBlocks[k]) continue;
+
+			const SDL_Rect& rect = scene.blocks[k].rect;
+			if (changed) SDL_UnionRect(&region, &rect, &region);
+			else region = rect;
+			changed = true;
+			mStaticBlocks[k] = look;
+		}
+		// acertos que nao mudaram o desenho de bloco nenhum
+		if (!changed) return;
+	}
+	mStaticDirty = false;
+
+	SDL_SetRenderTarget(mRenderer, mStaticLayer);
+	SDL_RenderSetClipRect(mRenderer, &region);
+
+	// fundo azul por baixo do que vai ser redesenhado
+	SDL_SetRenderDrawColor(mRenderer, 0, 0, 255, 255);
+	SDL_RenderFillRect(mRenderer, &region);
+	mDrawCalls++;
+	DrawStaticLayer(scene, region);
+
+	SDL_RenderSetClipRect(mRenderer, nullptr);
+	SDL_SetRenderTarget(mRenderer, nullptr);
+}
+
+int SdlSceneRenderer::Render(const Scene& scene)
+{
+	mDrawCalls = 0;
+
+	// paredes e blocos ficam numa textura, refeita (antes de mexer no
+	// back buffer) so quando algum bloco muda
+	if (mStaticLayer)
+	{
+		UpdateStaticLayer(scene);
+	}
+	UpdateHud(scene);
+
+	// Setamos a cor de fundo para azul
+	SDL_SetRenderDrawColor(
+		mRenderer,
+		0,   // R
+		0,   // G
+		255, // B
+		255  // A
+	);
+
+	// limpa o back buffer
+	SDL_RenderClear(mRenderer);
+	mDrawCalls++;
+
+	if (mStaticLayer)
+	{
+		SDL_RenderCopy(mRenderer, mStaticLayer, nullptr, nullptr);
+		mDrawCalls++;
+	}
+	else
+	{
+		SDL_Rect screen = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+		DrawStaticLayer(scene, screen);
+	}
+
+	if (mSprites)
+	{
+		CopyLayer(scene.paddles, mSheet->Paddle());
+		CopyLayer(scene.balls, mSheet->Ball());
+	}
+	else
+	{
+		// raquetes verdes e bolas vermelhas, um SDL_RenderFillRects por cor
+		FillLayer(scene.paddles, 0, 255, 0);
+		FillLayer(scene.balls, 255, 0, 0);
+	}
+
+	DrawHud(scene);
+
+	// Swap front buffer and back buffer
+	SDL_RenderPresent(mRenderer);
+	return mDrawCalls;
+}
+
+void SdlSceneRenderer::UpdateHud(const Scene& scene)
+{
+	SDL_Color white = { 255, 255, 255, 255 };
+
+	// o texto muda poucas vezes por minuto, entao quase sempre nao ha
+	// nada a montar
+	for (int k = 0; k < HUD_LABELS; k++) {
+		mHud.Update(mRenderer, mText, k, scene.hud[k].text, white);
+	}
+}
+
+void SdlSceneRenderer::DrawHud(const Scene& scene)
+{
+	// a textura guardada de cada label
+	for (int k = 0; k < HUD_LABELS; k++) {
+		const HudText& label = scene.hud[k];
+		mDrawCalls += mHud.Draw(mRenderer, mText, k, label.x, label.y);
+	}
+
+	mHud.EndFrame();
+}
+
+void SdlSceneRenderer::FillLayer(const std::vector<SDL_Rect>& rects, Uint8 r, Uint8 g, Uint8 b)
+{
+	if (rects.empty()) return;
+
+	SDL_SetRenderDrawColor(mRenderer, r, g, b, 255);
+	SDL_RenderFillRects(mRenderer, rects.data(), static_cast<int>(rects.size()));
+	mDrawCalls++;
+}
+
+void SdlSceneRenderer::CopyLayer(const std::vector<SDL_Rect>& rects, int sprite)
+{
+	// o SDL_Renderer so troca a textura quando ela muda, entao as copias
+	// seguidas da mesma textura saem sem troca de estado
+	const SDL_Rect& source = mSheet->Rect(sprite);
+	for (const SDL_Rect& rect : rects) {
+		SDL_RenderCopy(mRenderer, mSprites, &source, &rect);
+	}
+	mDrawCalls += static_cast<int>(rects.size());
+}
+
+void SdlSceneRenderer::LogStats(unsigned long long frames) const
+{
+	SDL_Log("HUD: %lu labels montados em %llu frames", mHud.Composed(), frames);
+}
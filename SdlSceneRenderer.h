@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <vector>
+
+#include "SDL/SDL.h"
+#include "SDL/SDL_ttf.h"
+
+#include "LabelCache.h"
+#include "SceneRenderer.h"
+#include "SpriteSheet.h"
+#include "TextAtlas.h"
+
+// Desenho com SDL_Renderer: paredes e blocos numa textura alvo refeita
+// so onde algum bloco mudou, raquetes e bolas por cima, e o HUD pelo
+// LabelCache, montado dos glifos de um TextAtlas. Com sprites, tudo
+// sai da mesma textura (uma copia por objeto); sem eles, um
+// SDL_RenderFillRects por cor.
+class SdlSceneRenderer : public SceneRenderer
+{
+public:
+	SdlSceneRenderer();
+	~SdlSceneRenderer();
+
+	// Cria o SDL_Renderer da janela; false se nao conseguiu. sprites
+	// precisa durar tanto quanto o renderizador (os pixels, so ate aqui).
+	bool Initialize(SDL_Window* window, TTF_Font* font, const SpriteSheet& sprites);
+
+	const char* Name() const override { return "SDL_Renderer"; }
+	int Render(const Scene& scene) override;
+	void HandleEvent(const SDL_Event& event) override;
+	void LogStats(unsigned long long frames) const override;
+
+private:
+	// Desenha uma camada de retangulos da mesma cor numa chamada so
+	void FillLayer(const std::vector<SDL_Rect>& rects, Uint8 r, Uint8 g, Uint8 b);
+	// Copia o mesmo sprite em cada retangulo
+	void CopyLayer(const std::vector<SDL_Rect>& rects, int sprite);
+	// Textura com a imagem do sprite sheet, se ele foi carregado
+	void CreateSpriteTexture();
+	// Como um bloco aparece na textura alvo (0 fora da tela), para saber
+	// se precisa redesenhar
+	int BlockLook(const SceneBlock& block) const;
+	// (Re)cria a textura das paredes e blocos, se o renderizador permite
+	void CreateStaticLayer();
+	// Redesenha na textura a parte que mudou desde o ultimo frame
+	void UpdateStaticLayer(const Scene& scene);
+	// Paredes e blocos que tocam region, no alvo atual
+	void DrawStaticLayer(const Scene& scene, const SDL_Rect& region);
+	// Monta de novo os labels do HUD que mudaram (troca o alvo, entao
+	// vem antes de desenhar no back buffer)
+	void UpdateHud(const Scene& scene);
+	// Placar, bolas e blocos restantes
+	void DrawHud(const Scene& scene);
+
+	// Renderer for 2D drawing
+	SDL_Renderer* mRenderer;
+	// glifos da fonte, rasterizados uma vez no Initialize
+	TextAtlas mText;
+	// sprites e a textura deles (nullptr para cores solidas)
+	const SpriteSheet* mSheet;
+	SDL_Texture* mSprites;
+	// labels do HUD, montados do atlas so quando o texto muda
+	LabelCache mHud;
+
+	// Paredes e blocos desenhados uma vez numa textura alvo (nullptr se
+	// o renderizador nao tem); blockVersion da cena e BlockLook de cada
+	// bloco quando ela foi atualizada, para refazer so o que mudou
+	SDL_Texture* mStaticLayer;
+	uint64_t mStaticVersion;
+	std::vector<int> mStaticBlocks;
+	// refazer a textura inteira (recem-criada ou perdida pelo driver)
+	bool mStaticDirty;
+
+	// blocos que tocam a regiao redesenhada, sem alocar por frame
+	std::vector<SDL_Rect> mBlockRects;
+	std::vector<int> mBlockSprites;
+	// chamadas de desenho do frame atual
+	int mDrawCalls;
+};
@@ -0,0 +1,183 @@
+/* ----------------------------------------------------------------
+ * From Game Programming in C++ by Sanjay Madhav
+ * Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+ *
+ * Released under the BSD License
+ * See LICENSE in root directory for full details.
+ * ---------------------------------------------------------------- */
+
+/* Memoria compartilhada entre o Headless (--shm NOME) e um processo de
+ * treino. Header em C puro, usado pelos dois lados.
+ *
+ * O objeto POSIX NOME (shm_open) comeca com SharedEnvHeader e segue com
+ * um anel de slots slots. O slot do passo n e o n % slots e guarda:
+ *   actions[envs]    int32, escritas pelo cliente para o passo n
+ *   rewards[envs]    float
+ *   dones[envs]      uint8 (preenchido ate multiplo de 4)
+ *   obs[envs * obsFloats]            float, VecEnv::Observe
+ *   pixels[envs * width * height * channels]  uint8, Rasterize (opcional)
+ * O servidor escreve o resultado do passo direto no slot (VecEnv::Step e
+ * VecEnv::Render recebem ponteiros para ele), entao nada e copiado.
+ *
+ * Passagem de vez, com dois contadores:
+ *   - o passo 0 e o Reset: o servidor preenche o slot 0 e faz ready = 1
+ *   - o cliente espera ready > n - 1, le o slot (n - 1) % slots, escreve
+ *     as acoes no slot n % slots e faz submitted = n
+ *   - o servidor espera submitted >= n, avanca, escreve o slot n % slots
+ *     e faz ready = n + 1
+ * Um quadro k continua valido ate o cliente enviar o passo k + slots, o
+ * que permite empilhar quadros sem copiar. quit = 1 (seguido de um wake
+ * em submitted) encerra o servidor.
+ *
+ * A espera gira um pouco e depois dorme num futex (Linux) ou cede o
+ * processador (outros sistemas POSIX). */
+
+#ifndef SHARED_ENV_H
+#define SHARED_ENV_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SHARED_ENV_MAGIC 0x4D4B5241u   /* "ARKM" */
+#define SHARED_ENV_VERSION 1u
+
+/* alguns campos da observacao (ObservationField em VecEnv.h) */
+#define SHARED_ENV_OBS_PADDLE_X 0
+#define SHARED_ENV_OBS_BALL_X 1
+
+typedef struct SharedEnvHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t envs;
+	uint32_t slots;
+	uint32_t obsFloats;
+	/* pixels por ambiente (width = 0: sem pixels) */
+	uint32_t width;
+	uint32_t height;
+	uint32_t channels;
+	/* deslocamentos dentro de um slot e tamanho do slot, em bytes */
+	uint32_t rewardsOffset;
+	uint32_t donesOffset;
+	uint32_t obsOffset;
+	uint32_t pixelsOffset;
+	uint32_t slotSize;
+	/* deslocamento do slot 0 a partir do inicio do objeto */
+	uint32_t firstSlot;
+	/* cada contador numa linha de cache propria */
+	uint32_t pad0[2];
+	uint32_t submitted;
+	uint32_t pad1[15];
+	uint32_t ready;
+	uint32_t pad2[15];
+	uint32_t quit;
+	uint32_t pad3[15];
+} SharedEnvHeader;
+
+/* Tamanhos do slot para envs ambientes; devolve o tamanho total, ou 0
+ * se um deslocamento ou o slot nao cabe nos campos de 32 bits (ou o
+ * total nao cabe num size_t). As contas sao em 64 bits: com uint32_t,
+ * muitos ambientes com pixels grandes dariam a volta sem aviso. */
+static inline size_t SharedEnvLayout(SharedEnvHeader* h)
+{
+	uint64_t envs = h->envs;
+	uint64_t frame, rewards, dones, obs, pixels, slot, first, total;
+
+	/* cada produto de dois fatores de 32 bits cabe em 64 bits */
+	if (envs * h->obsFloats > UINT32_MAX) return 0;
+	frame = (uint64_t)h->width * h->height;
+	if (frame > UINT32_MAX) return 0;
+	frame *= h->channels;
+	if (frame > UINT32_MAX) return 0;
+
+	rewards = 4 * envs;
+	dones = rewards + 4 * envs;
+	obs = dones + ((envs + 3) & ~(uint64_t)3);
+	pixels = obs + 4 * envs * h->obsFloats;
+	/* slots alinhados em 64 bytes */
+	slot = (pixels + envs * frame + 63) & ~(uint64_t)63;
+	if (slot > UINT32_MAX) return 0;
+	first = (sizeof(SharedEnvHeader) + 63) & ~(uint64_t)63;
+	total = first + h->slots * slot;
+	if (total > SIZE_MAX) return 0;
+
+	h->rewardsOffset = (uint32_t)rewards;
+	h->donesOffset = (uint32_t)dones;
+	h->obsOffset = (uint32_t)obs;
+	h->pixelsOffset = (uint32_t)pixels;
+	h->slotSize = (uint32_t)slot;
+	h->firstSlot = (uint32_t)first;
+	return (size_t)total;
+}
+
+static inline unsigned char* SharedEnvSlot(SharedEnvHeader* h, uint32_t step)
+{
+	return (unsigned char*)h + h->firstSlot + (size_t)(step % h->slots) * h->slotSize;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+
+#include <sched.h>
+#include <time.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static inline uint32_t SharedEnvLoad(const uint32_t* word)
+{
+	return __atomic_load_n(word, __ATOMIC_ACQUIRE);
+}
+
+/* Acorda quem espera em word */
+static inline void SharedEnvWake(uint32_t* word)
+{
+#if defined(__linux__)
+	syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0);
+#else
+	(void)word;
+#endif
+}
+
+/* Publica value em word e acorda quem espera nele */
+static inline void SharedEnvPublish(uint32_t* word, uint32_t value)
+{
+	__atomic_store_n(word, value, __ATOMIC_RELEASE);
+	SharedEnvWake(word);
+}
+
+/* Pede para o servidor encerrar */
+static inline void SharedEnvQuit(SharedEnvHeader* h)
+{
+	__atomic_store_n(&h->quit, 1u, __ATOMIC_RELEASE);
+	SharedEnvWake(&h->submitted);
+}
+
+/* Espera word chegar a target (ou quit ficar 1); devolve o valor lido */
+static inline uint32_t SharedEnvWait(uint32_t* word, uint32_t target, const uint32_t* quit)
+{
+	int spins = 0;
+	for (;;) {
+		uint32_t value = SharedEnvLoad(word);
+		/* comparacao com volta do contador */
+		if ((int32_t)(value - target) >= 0) return value;
+		if (quit && SharedEnvLoad(quit)) return value;
+
+		if (spins < 1000) {
+			spins++;
+			continue;
+		}
+#if defined(__linux__)
+		/* acorda de tempos em tempos para conferir o quit */
+		struct timespec timeout = { 0, 100000000 };
+		syscall(SYS_futex, word, FUTEX_WAIT, value, &timeout, NULL, 0);
+#else
+		sched_yield();
+#endif
+	}
+}
+
+#endif
+
+#endif
@@ -0,0 +1,158 @@
+/* ----------------------------------------------------------------
+ * From Game Programming in C++ by Sanjay Madhav
+ * Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+ *
+ * Released under the BSD License
+ * See LICENSE in root directory for full details.
+ * ---------------------------------------------------------------- */
+
+/* Cliente de referencia da memoria compartilhada do Headless (--shm) e
+ * benchmark de latencia/vazao da passagem de vez.
+ *
+ * uso: SharedEnvClient NOME [PASSOS]
+ *
+ * Joga PASSOS passos (padrao 10000) com a raquete seguindo a bola
+ * observada, lendo as observacoes e escrevendo as acoes direto no anel,
+ * e imprime passos/s e a latencia de cada passo (acoes publicadas ate o
+ * resultado pronto). No fim pede para o servidor encerrar.
+ *
+ * Compilar (Linux/macOS): cc -O2 -o SharedEnvClient SharedEnvClient.c
+ * (no Linux antigo tambem -lrt) */
+
+/* syscall, clock_gettime e usleep tambem com -std=c99 */
+#define _GNU_SOURCE
+
+#include "SharedEnv.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static double Now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static int CompareDoubles(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+/* Abre o objeto do servidor, esperando ate 5 s ele aparecer */
+static SharedEnvHeader* Attach(const char* name, size_t* size)
+{
+	char path[256];
+	snprintf(path, sizeof(path), "%s%s", name[0] == '/' ? "" : "/", name);
+
+	double deadline = Now() + 5.0;
+	for (;;) {
+		int fd = shm_open(path, O_RDWR, 0);
+		struct stat info;
+		if (fd >= 0 && fstat(fd, &info) == 0 && info.st_size >= (off_t)sizeof(SharedEnvHeader)) {
+			void* memory = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			close(fd);
+			if (memory == MAP_FAILED) {
+				perror("mmap");
+				return NULL;
+			}
+			SharedEnvHeader* h = (SharedEnvHeader*)memory;
+			/* a magica e a ultima coisa que o servidor escreve */
+			while (SharedEnvLoad(&h->magic) != SHARED_ENV_MAGIC && Now() < deadline) {
+				usleep(1000);
+			}
+			if (h->magic == SHARED_ENV_MAGIC && h->version == SHARED_ENV_VERSION) {
+				*size = info.st_size;
+				return h;
+			}
+			fprintf(stderr, "%s nao e um ambiente compartilhado valido\n", path);
+			munmap(memory, info.st_size);
+			return NULL;
+		}
+		if (fd >= 0) close(fd);
+		if (Now() >= deadline) {
+			fprintf(stderr, "nao foi possivel abrir %s\n", path);
+			return NULL;
+		}
+		usleep(10000);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "uso: %s NOME [PASSOS]\n", argv[0]);
+		return 1;
+	}
+	long steps = argc > 2 ? atol(argv[2]) : 10000;
+	if (steps <= 0) steps = 1;
+
+	size_t size;
+	SharedEnvHeader* h = Attach(argv[1], &size);
+	if (!h) return 1;
+
+	uint32_t envs = h->envs;
+	printf("%u ambientes, %u floats de observacao, pixels %ux%ux%u, %u slots\n",
+		envs, h->obsFloats, h->width, h->height, h->channels, h->slots);
+
+	double* latency = (double*)malloc(steps * sizeof(double));
+	if (!latency) return 1;
+
+	/* o passo 0 (Reset) */
+	SharedEnvWait(&h->ready, 1, NULL);
+
+	long episodes = 0;
+	double totalReward = 0.0;
+	double start = Now();
+
+	for (long n = 1; n <= steps; n++) {
+		unsigned char* last = SharedEnvSlot(h, (uint32_t)(n - 1));
+		unsigned char* next = SharedEnvSlot(h, (uint32_t)n);
+		const float* obs = (const float*)(last + h->obsOffset);
+		int32_t* actions = (int32_t*)next;
+
+		/* raquete atras da bola observada */
+		for (uint32_t i = 0; i < envs; i++) {
+			const float* o = obs + (size_t)i * h->obsFloats;
+			float diff = o[SHARED_ENV_OBS_BALL_X] - o[SHARED_ENV_OBS_PADDLE_X];
+			actions[i] = diff < -0.01f ? -1 : (diff > 0.01f ? 1 : 0);
+		}
+
+		double sent = Now();
+		SharedEnvPublish(&h->submitted, (uint32_t)n);
+		SharedEnvWait(&h->ready, (uint32_t)(n + 1), NULL);
+		latency[n - 1] = Now() - sent;
+
+		const float* rewards = (const float*)(next + h->rewardsOffset);
+		const unsigned char* dones = next + h->donesOffset;
+		for (uint32_t i = 0; i < envs; i++) {
+			totalReward += rewards[i];
+			episodes += dones[i];
+		}
+	}
+
+	double seconds = Now() - start;
+	SharedEnvQuit(h);
+
+	qsort(latency, steps, sizeof(double), CompareDoubles);
+	double sum = 0.0;
+	for (long n = 0; n < steps; n++) sum += latency[n];
+
+	printf("passos: %ld em %.3f s (%.0f passos/s, %.0f passos de ambiente/s)\n",
+		steps, seconds, steps / seconds, (double)steps * envs / seconds);
+	printf("partidas terminadas: %ld, recompensa total: %.0f\n", episodes, totalReward);
+	printf("latencia por passo (us): media %.1f, p50 %.1f, p99 %.1f, max %.1f\n",
+		sum / steps * 1e6, latency[steps / 2] * 1e6,
+		latency[steps * 99 / 100] * 1e6, latency[steps - 1] * 1e6);
+
+	free(latency);
+	munmap(h, size);
+	return 0;
+}
@@ -0,0 +1,125 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "SharedEnvServer.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#if defined(_WIN32)
+
+int ServeSharedEnv(const char* name, VecEnv&, const RasterConfig*, int)
+{
+	// a passagem de vez usa futex/shm_open, que o Windows nao tem
+	fprintf(stderr, "--shm %s: memoria compartilhada so em sistemas POSIX\n", name);
+	return 1;
+}
+
+#else
+
+#include "SharedEnv.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(SHARED_ENV_OBS_PADDLE_X == OBS_PADDLE_X && SHARED_ENV_OBS_BALL_X == OBS_BALL_X,
+	"SharedEnv.h fora de sincronia com VecEnv.h");
+
+int ServeSharedEnv(const char* name, VecEnv& env, const RasterConfig* raster, int slots)
+{
+	// shm_open quer o nome comecando com barra
+	std::string path = name[0] == '/' ? name : std::string("/") + name;
+
+	SharedEnvHeader layout = {};
+	layout.envs = env.Size();
+	layout.slots = slots;
+	layout.obsFloats = OBS_SIZE;
+	if (raster) {
+		layout.width = raster->width;
+		layout.height = raster->height;
+		layout.channels = raster->format;
+	}
+	size_t size = SharedEnvLayout(&layout);
+	if (size == 0) {
+		fprintf(stderr, "memoria compartilhada: %d ambientes com esses pixels nao cabem "
+			"num slot (deslocamentos de 32 bits)\n", env.Size());
+		return 1;
+	}
+
+	// um objeto esquecido por um servidor que caiu e substituido
+	shm_unlink(path.c_str());
+	int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0) {
+		perror("shm_open");
+		return 1;
+	}
+	if (ftruncate(fd, size) != 0) {
+		perror("ftruncate");
+		close(fd);
+		shm_unlink(path.c_str());
+		return 1;
+	}
+	void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (memory == MAP_FAILED) {
+		perror("mmap");
+		shm_unlink(path.c_str());
+		return 1;
+	}
+
+	// a magica vai por ultimo: o cliente so usa o cabecalho depois dela
+	SharedEnvHeader* h = static_cast<SharedEnvHeader*>(memory);
+	layout.magic = 0;
+	layout.version = SHARED_ENV_VERSION;
+	*h = layout;
+	__atomic_store_n(&h->magic, SHARED_ENV_MAGIC, __ATOMIC_RELEASE);
+
+	printf("memoria compartilhada %s: %d ambientes, %d slots de %u bytes\n",
+		path.c_str(), env.Size(), slots, h->slotSize);
+	fflush(stdout);
+
+	// os resultados sao escritos direto no slot do passo
+	auto rewards = [h](unsigned char* slot) { return reinterpret_cast<float*>(slot + h->rewardsOffset); };
+	auto dones = [h](unsigned char* slot) { return slot + h->donesOffset; };
+	auto observations = [h](unsigned char* slot) { return reinterpret_cast<float*>(slot + h->obsOffset); };
+
+	// passo 0: o Reset
+	unsigned char* slot = SharedEnvSlot(h, 0);
+	env.Reset(observations(slot));
+	for (int i = 0; i < env.Size(); i++) {
+		rewards(slot)[i] = 0.0f;
+		dones(slot)[i] = 0;
+	}
+	if (raster) env.Render(*raster, slot + h->pixelsOffset);
+	SharedEnvPublish(&h->ready, 1);
+
+	auto start = std::chrono::steady_clock::now();
+	uint32_t step = 1;
+	for (;; step++) {
+		SharedEnvWait(&h->submitted, step, &h->quit);
+		if (SharedEnvLoad(&h->quit)) break;
+
+		slot = SharedEnvSlot(h, step);
+		env.Step(reinterpret_cast<const int*>(slot), observations(slot), rewards(slot), dones(slot));
+		if (raster) env.Render(*raster, slot + h->pixelsOffset);
+		SharedEnvPublish(&h->ready, step + 1);
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	long steps = static_cast<long>(step - 1);
+	printf("passos servidos: %ld em %.3f s (%.0f passos/s, %.0f passos de ambiente/s)\n",
+		steps, seconds, seconds > 0.0 ? steps / seconds : 0.0,
+		seconds > 0.0 ? (double)steps * env.Size() / seconds : 0.0);
+
+	munmap(memory, size);
+	shm_unlink(path.c_str());
+	return 0;
+}
+
+#endif
@@ -0,0 +1,17 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+
+#include "VecEnv.h"
+
+// Cria a memoria compartilhada name (protocolo em SharedEnv.h) e avanca
+// env com as acoes que o cliente escreve nela, ate o cliente pedir para
+// sair. raster (opcional) tambem desenha os pixels de cada passo.
+// Devolve o codigo de saida do processo.
+int ServeSharedEnv(const char* name, VecEnv& env, const RasterConfig* raster, int slots);
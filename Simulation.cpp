@@ -0,0 +1,693 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+// 
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "Simulation.h"
+#include "WorkerPool.h"
+#include <cmath>
+#include <cstring>
+
+// abaixo disso por worker, nao vale a pena dividir as bolas entre threads
+const size_t min_balls_per_worker = 512;
+// batidas (raquete ou bloco) resolvidas por bola em um tick
+const int max_sweep_hits = 4;
+
+float get_sign(float n)
+{
+	return n / fabsf(n);
+}
+
+
+// cria a bola que nasce da divisao de b, com velocidade (vx, vy)
+// mais uma pequena variacao aleatoria; so sorteia quando divide
+static void SpawnSplit(BallStore& balls, const Ball& b, float vx, float vy, Random& random)
+{
+	float var_x = random.Uniform(-0.5f * b.acc.x, 0.5f * b.acc.x);
+	float var_y = random.Uniform(-0.5f * b.acc.x, 0.5f * b.acc.x);
+
+	//printf("var x: %.2f, var y: %.2f\n", var_x, var_y);
+
+	balls.Spawn(Ball(b.pos.x, b.pos.y, vx + var_x, vy + var_y, thickness, thickness));
+}
+
+// Hash do estado: palavras de 64 bits misturadas com multiplicacoes
+// e rotacoes, bem mais rapido que byte a byte
+const uint64_t hash_k1 = 0x9E3779B97F4A7C15ULL;
+const uint64_t hash_k2 = 0xC2B2AE3D27D4EB4FULL;
+
+static uint64_t HashWord(uint64_t h, uint64_t word)
+{
+	h ^= word * hash_k1;
+	h = (h << 31) | (h >> 33);
+	return h * hash_k2;
+}
+
+static uint64_t HashBytes(uint64_t h, const void* data, size_t size)
+{
+	const unsigned char* p = static_cast<const unsigned char*>(data);
+
+	// quatro somas independentes, para as multiplicacoes nao
+	// esperarem umas pelas outras
+	size_t blocks = size / 32;
+	if (blocks > 0) {
+		uint64_t lane[4] = { h, h + hash_k1, h + hash_k2, h - hash_k1 };
+		for (size_t i = 0; i < blocks; i++) {
+			for (int k = 0; k < 4; k++) {
+				uint64_t word;
+				memcpy(&word, p + 32 * i + 8 * k, 8);
+				lane[k] = HashWord(lane[k], word);
+			}
+		}
+		h = HashWord(HashWord(HashWord(lane[0], lane[1]), lane[2]), lane[3]);
+	}
+
+	size_t words = size / 8;
+	for (size_t i = blocks * 4; i < words; i++) {
+		uint64_t word;
+		memcpy(&word, p + 8 * i, 8);
+		h = HashWord(h, word);
+	}
+	uint64_t tail = 0;
+	memcpy(&tail, p + 8 * words, size - 8 * words);
+	return HashWord(h, tail ^ size);
+}
+
+// espalha os bits (finalizador do MurmurHash3)
+static uint64_t Avalanche(uint64_t h)
+{
+	h ^= h >> 33;
+	h *= 0xFF51AFD7ED558CCDULL;
+	h ^= h >> 33;
+	h *= 0xC4CEB9FE1A85EC53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+// contribuicao de um bloco; somadas, nao dependem da ordem das batidas
+static uint64_t BlockHash(size_t index, const Block& block)
+{
+	return Avalanche(HashWord(index, static_cast<uint64_t>(block.taps) * 2 + block.onScreen));
+}
+
+Simulation::Simulation()
+	:tick(0)
+	,blocksAlive(0)
+	,blocksDestroyed(0)
+	,blockVersion(0)
+	,stateHash(0)
+	,blockHash(0)
+{
+	
+}
+
+Simulation::Simulation(const Simulation& other)
+	:Simulation()
+{
+	*this = other;
+}
+
+Simulation& Simulation::operator=(const Simulation& other)
+{
+	if (this == &other) return *this;
+
+	// CopyFrom mantem as threads deste objeto; uma copia usa as do
+	// original, num pool so dela
+	config.threads = other.config.threads;
+	CopyFrom(other);
+	CreatePool();
+	return *this;
+}
+
+Simulation::~Simulation()
+{
+}
+
+void Simulation::CreatePool()
+{
+	// o pool de threads so e recriado se o numero de threads mudar
+	if (config.threads <= 1) pool.reset();
+	else if (!pool || pool->Size() != config.threads) {
+		pool.reset(new WorkerPool(config.threads));
+	}
+}
+
+void Simulation::Initialize(const SimConfig& simConfig)
+{
+	config = simConfig;
+	// sempre cabe pelo menos a bola inicial (um replay ou uma
+	// configuracao invalida poderia pedir 0 ou menos)
+	if (config.maxBalls < 1) config.maxBalls = 1;
+	splitRandom.Seed(config.seed, STREAM_SPLIT);
+	tick = 0;
+
+	CreatePool();
+
+	vPaddle = std::vector<Paddle>();
+	vPaddle.push_back(
+		Paddle(SCREEN_WIDTH/2.0f, 
+			SCREEN_HEIGHT - 2*thickness, 
+			100.0f, 
+			thickness,
+			300.0f)
+	);
+	
+	vBall.Clear();
+	vBall.Reserve(config.maxBalls);
+	vBall.Add(
+		Ball(SCREEN_WIDTH / 2.0f - thickness / 2.0f,
+			 SCREEN_HEIGHT / 2.0f - thickness / 2.0f,
+			 100.0f,
+			 200.0f, 
+			 thickness, 
+			 thickness)
+	);
+
+	//taps = 0;
+
+	goals = std::vector<int>((size_t)2);
+
+	map = BlockMap(SCREEN_WIDTH - 2 * thickness, SCREEN_HEIGHT / 3.0f - thickness, config.columns, config.rows,
+		thickness, thickness);
+
+	float width = map.cellWidth;
+	float height = map.cellHeight;
+	float top = map.top;
+	float left = map.left;
+
+	// espaco entre blocos; diminui em mapas com celulas muito pequenas
+	float gap = fminf(thickness / 4.0f, fminf(width, height) / 4.0f);
+
+	vBlock = std::vector<Block>();
+	vBlock.reserve(map.Rows() * map.Columns());
+
+	int i = 0;
+	for (auto const& row : map.matrix) {
+		for (int j = 0; j < map.matrixWidth; j++) {
+			float x = left + j * width + gap;
+			float y = top + i * height + gap;
+			vBlock.push_back(Block(x, y, width - 2 * gap, height - 2 * gap, row[j] == 1));
+		}
+		i++;
+	}
+
+	RebuildBlockState();
+	UpdateHash();
+}
+
+void Simulation::RebuildBlockState()
+{
+	blockBoxes.Resize(vBlock.size());
+	blockVersion++;
+	blockHash = 0;
+	blocksAlive = 0;
+	blocksDestroyed = 0;
+	for (size_t k = 0; k < vBlock.size(); k++) {
+		const Block& block = vBlock[k];
+		if (block.onScreen) {
+			blockBoxes.Set(k, block.pos.x, block.pos.y, block.width, block.height);
+			blocksAlive++;
+		}
+		// bloco do mapa que nao esta mais na tela foi destruido
+		else if (map.matrix[k / map.Columns()][k % map.Columns()] == 1) {
+			blocksDestroyed++;
+		}
+		blockHash += BlockHash(k, block);
+	}
+}
+
+int Simulation::SweepBlocks(float x, float y, float w, float h, float vx, float vy,
+	float maxTime, float& time, bool& hitX) const
+{
+	// caixa varrida pelo caminho inteiro; fora do mapa, nada a testar
+	float ex = x + vx * maxTime, ey = y + vy * maxTime;
+	float sx = fminf(x, ex), sy = fminf(y, ey);
+	float sw = fabsf(ex - x) + w, sh = fabsf(ey - y) + h;
+	int row0, col0, row1, col1;
+	if (!map.CellRange(sx, sy, sw, sh, row0, col0, row1, col1)) return -1;
+
+	// caminhos mais longos que uma celula sao percorridos em trechos,
+	// olhando so as celulas que cada trecho cobre; num tick normal
+	// o caminho inteiro e um trecho so
+	float size = fmaxf(fmaxf(map.cellWidth, map.cellHeight), fmaxf(w, h));
+	float chunk = maxTime;
+	if (fabsf(ex - x) > size || fabsf(ey - y) > size) {
+		chunk = size / sqrtf(vx * vx + vy * vy);
+	}
+
+	float best = maxTime;
+	int found = -1;
+	for (float t0 = 0.0f; t0 < best; t0 += chunk) {
+		float t1 = fminf(t0 + chunk, best);
+		bool cells = true;
+		if (chunk < maxTime) {
+			float ax = x + vx * t0, ay = y + vy * t0;
+			float bx = x + vx * t1, by = y + vy * t1;
+			sx = fminf(ax, bx); sy = fminf(ay, by);
+			sw = fabsf(bx - ax) + w; sh = fabsf(by - ay) + h;
+			cells = map.CellRange(sx, sy, sw, sh, row0, col0, row1, col1);
+		}
+
+		if (cells) {
+			for (int r = row0; r <= row1; r++)
+			for (int c = col0; c <= col1; c += 8) {
+				// filtro em lote: so faz a conta exata nos blocos que a
+				// caixa varrida toca (destruidos tem caixa vazia)
+				int n = col1 - c + 1 < 8 ? col1 - c + 1 : 8;
+				int first = map.Index(r, c);
+				unsigned mask = OverlapMask(sx, sy, sw, sh, blockBoxes, first, n);
+				for (int j = 0; j < n; j++) {
+					if (!(mask & (1u << j))) continue;
+					int k = first + j;
+
+					float t;
+					bool x_face;
+					if (SweepBox(x, y, w, h, vx, vy,
+						blockBoxes.minX[k], blockBoxes.minY[k], blockBoxes.maxX[k], blockBoxes.maxY[k],
+						best, t, x_face)
+						&& (found < 0 || t < best)) {
+						best = t;
+						hitX = x_face;
+						found = k;
+					}
+				}
+			}
+		}
+
+		// achou colisao dentro deste trecho: os seguintes sao mais tarde
+		if (found >= 0 && best <= t1) break;
+	}
+
+	time = best;
+	return found;
+}
+
+// Atualiza as bolas [begin, end): movimento, raquetes, blocos e paredes.
+// Le blocos e raquetes sem altera-los; batidas em blocos e divisoes
+// ficam em work, para a juncao aplicar na ordem das bolas.
+void Simulation::UpdateBalls(size_t begin, size_t end, float deltaTime, bool canSplit, BallWork& work)
+{
+	float* posX = vBall.posX.data();
+	float* posY = vBall.posY.data();
+	float* velX = vBall.velX.data();
+	float* velY = vBall.velY.data();
+	int* taps = vBall.taps.data();
+	unsigned char* alive = vBall.alive.data();
+	unsigned char* bounceX = vBall.bounceX.data();
+	unsigned char* bounceY = vBall.bounceY.data();
+	unsigned char* sweep = vBall.sweep.data();
+
+	// caixa que cobre as raquetes na tela, com um pixel de folga
+	bool paddles = false;
+	float padLeft = 0.0f, padTop = 0.0f, padRight = 0.0f, padBottom = 0.0f;
+	for (auto const& paddle : vPaddle) {
+		if (!paddle.onScreen) continue;
+		float l = paddle.pos.x - 1.0f, t = paddle.pos.y - 1.0f;
+		float r = paddle.pos.x + paddle.width + 1.0f, b = paddle.pos.y + paddle.height + 1.0f;
+		padLeft = paddles ? fminf(padLeft, l) : l;
+		padTop = paddles ? fminf(padTop, t) : t;
+		padRight = paddles ? fmaxf(padRight, r) : r;
+		padBottom = paddles ? fmaxf(padBottom, b) : b;
+		paddles = true;
+	}
+	// o mesmo teste barato de BlockMap::CellRange, que faz SweepBlocks
+	// desistir logo quando a caixa varrida esta fora do mapa
+	const bool blocks = map.cellWidth > 0 && map.cellHeight > 0;
+	const float mapLeft = map.left;
+	const float mapTop = map.top;
+	const float mapRight = map.left + map.windowWidth;
+	const float mapBottom = map.top + map.windowHeight;
+	const float size = static_cast<float>(thickness);
+
+	// passada linear: marca as bolas cuja caixa varrida no tick inteiro
+	// pode tocar uma raquete ou o mapa de blocos
+	for (size_t i = begin; i < end; i++)
+	{
+		float x = posX[i], y = posY[i];
+		float ex = x + velX[i] * deltaTime;
+		float ey = y + velY[i] * deltaTime;
+		// as mesmas contas de SweepBlocks (min sem fminf, que nao vetoriza)
+		float sx = ex < x ? ex : x, sy = ey < y ? ey : y;
+		float sw = fabsf(ex - x) + size, sh = fabsf(ey - y) + size;
+		// & e | em vez de && e ||: sem desvio, a passada vetoriza
+		int block = blocks & (sx + sw >= mapLeft) & (sy + sh >= mapTop)
+			& (sx < mapRight) & (sy < mapBottom);
+		int paddle = paddles & (sx < padRight) & (padLeft < sx + sw)
+			& (sy < padBottom) & (padTop < sy + sh);
+		sweep[i] = static_cast<unsigned char>(block | paddle);
+	}
+
+	// as outras andam o tick inteiro sem bater em nada: a mesma conta
+	// da varredura sem colisao, direto nos vetores e sem desvio, para o
+	// compilador vetorizar (as marcadas andam 0 aqui e vao para a varredura)
+	for (size_t i = begin; i < end; i++)
+	{
+		float time = sweep[i] ? 0.0f : deltaTime;
+		posX[i] += velX[i] * time;
+		posY[i] += velY[i] * time;
+	}
+
+	// movimento com colisao continua: a bola anda ate a primeira raquete
+	// ou bloco no seu caminho, responde, e segue com o tempo que sobrou;
+	// assim uma bola rapida nao atravessa nada dentro de um tick.
+	// pedidos de divisao vao para work.splits e so viram bolas na juncao
+	for (size_t i = begin; i < end; i++)
+	{
+		if (!sweep[i]) continue;
+		Ball b = vBall.Get(i);
+		float remaining = deltaTime;
+
+		for (int sweep = 0; remaining > 0.0f; sweep++)
+		{
+			float time = remaining;
+			int paddleHit = -1;
+			int blockHit = -1;
+			bool hitX = false;
+
+			// depois de max_sweep_hits batidas o resto do tick e so movimento
+			if (sweep < max_sweep_hits) {
+				// raquetes, so com a bola descendo
+				for (size_t p = 0; p < vPaddle.size() && b.vel.y > 0.0f; p++) {
+					const Paddle& paddle = vPaddle[p];
+					if (!paddle.onScreen) continue;
+
+					float t = 0.0f;
+					bool x_face;
+					// a raquete andou por cima da bola: batida imediata;
+					// senao, a conta exata so perto da raquete
+					bool hit = b.collide(paddle.pos, paddle.width, paddle.height)
+						|| (b.pos.y + b.height + b.vel.y * time >= paddle.pos.y
+							&& SweepBox(b.pos.x, b.pos.y, b.width, b.height,
+							b.vel.x, b.vel.y, paddle.pos.x, paddle.pos.y,
+							paddle.pos.x + paddle.width, paddle.pos.y + paddle.height,
+							time, t, x_face));
+					if (hit && (paddleHit < 0 || t < time)) {
+						time = t;
+						paddleHit = static_cast<int>(p);
+					}
+				}
+
+				float t;
+				bool x_face;
+				int k = SweepBlocks(b.pos.x, b.pos.y, b.width, b.height, b.vel.x, b.vel.y,
+					time, t, x_face);
+				if (k >= 0 && (paddleHit < 0 || t < time)) {
+					time = t;
+					paddleHit = -1;
+					blockHit = k;
+					hitX = x_face;
+				}
+			}
+
+			b.pos.x += b.vel.x * time;
+			b.pos.y += b.vel.y * time;
+			remaining -= time;
+
+			// atualiza a velocidade da bola se ela colidiu com a raquete
+			if (paddleHit >= 0)
+			{
+				//printf("colidiu\n");
+				b.taps += 1;
+
+				b.vel.y *= -1.0f;
+
+				// acelera a cada colis�o
+				// depois adicionar condi��o de apertar barra de espa�o
+				// sem deltaTime, porque colisão não ocorre em todo frame
+				b.vel.x += get_sign(b.vel.x) * b.acc.x;
+				b.vel.y += get_sign(b.vel.y) * b.acc.y;
+				
+				//printf("vel_x: %.2f\n", b.vel.x);
+				if (canSplit && b.taps > min_taps) {
+					work.splits.push_back(SplitRequest(b, i, -b.vel.x, b.vel.y));
+					b.taps = 0;
+				}
+			}
+			// ou com um bloco: a face atingida vem do instante de contato
+			else if (blockHit >= 0)
+			{
+				b.taps += 1;
+				// o bloco so e atualizado na juncao, depois de todas as bolas
+				work.hits.push_back(blockHit);
+
+				// sem deltaTime, porque colisão não ocorre em todo frame
+				b.vel.x += get_sign(b.vel.x) * b.acc.x;
+				b.vel.y += get_sign(b.vel.y) * b.acc.y;
+
+				// colisão à esquerda ou à direita
+				if (hitX) {
+					b.vel.x *= -1.0f;
+
+					if (canSplit && b.taps > min_taps) {
+						work.splits.push_back(SplitRequest(b, i, b.vel.x, -b.vel.y));
+						b.taps = 0;
+					}
+				}
+				// colisão de cima ou de baixo
+				else {
+					b.vel.y *= -1.0f;
+
+					if (canSplit && b.taps > min_taps) {
+						work.splits.push_back(SplitRequest(b, i, -b.vel.x, b.vel.y));
+						b.taps = 0;
+					}
+				}
+			}
+			else break;
+		}
+
+		vBall.Set(i, b);
+	}
+
+	// paredes: outra passada linear, que so marca quem bateu
+	const bool closedBottom = config.closedBottom;
+	for (size_t i = begin; i < end; i++)
+	{
+		float b_top = posY[i];
+		float b_bottom = posY[i] + thickness;
+
+		float b_left = posX[i];
+		float b_right = posX[i] + thickness;
+
+		// parede da esquerda ou da direita
+		bool hitX = (b_left <= thickness && velX[i] < 0.0f)
+			|| (b_right >= SCREEN_WIDTH - thickness && velX[i] > 0.0f);
+		// parede de cima (ou a de baixo, se estiver fechada)
+		bool bottom = b_bottom >= SCREEN_HEIGHT && velY[i] > 0.0f;
+		bool hitY = (b_top <= thickness && velY[i] < 0.0f)
+			|| (closedBottom && bottom);
+		// parede de baixo
+		bool lost = !closedBottom && bottom;
+
+		velX[i] = hitX ? -velX[i] : velX[i];
+		velY[i] = hitY ? -velY[i] : velY[i];
+		taps[i] += hitX + hitY;
+		alive[i] = alive[i] && !lost;
+		bounceX[i] = hitX;
+		bounceY[i] = hitY;
+	}
+
+	// bolas que bateram numa parede e ja tem batidas suficientes
+	// se dividem, espelhando a bola na direcao da parede
+	for (size_t i = begin; i < end; i++)
+	{
+		if (!(bounceX[i] || bounceY[i])) continue;
+		if (canSplit && taps[i] > min_taps) {
+			Ball b = vBall.Get(i);
+			taps[i] = 0;
+
+			if (bounceX[i])
+				work.wallSplits.push_back(SplitRequest(b, i, b.vel.x, -b.vel.y));
+			else
+				work.wallSplits.push_back(SplitRequest(b, i, -b.vel.x, b.vel.y));
+		}
+	}
+}
+
+void Simulation::Step(float deltaTime, const SimInput& input)
+{
+	Advance(deltaTime, input);
+	UpdateHash();
+}
+
+int Simulation::StepRepeat(float deltaTime, const SimInput& input, int ticks)
+{
+	int done = 0;
+	while (done < ticks) {
+		Advance(deltaTime, input);
+		done++;
+		if (IsOver()) break;
+	}
+	UpdateHash();
+	return done;
+}
+
+void Simulation::Advance(float deltaTime, const SimInput& input)
+{
+	tick++;
+
+	// guarda as posicoes atuais para o desenho interpolar
+	// entre o tick anterior e este
+	for (auto& paddle : vPaddle) paddle.prev = paddle.pos;
+	vBall.prevX = vBall.posX;
+	vBall.prevY = vBall.posY;
+
+	// aplica a entrada de cada raquete; uma raquete escondida
+	// aparece (e zera o placar) quando o jogador a move
+	for (size_t p = 0; p < vPaddle.size() && p < max_paddles; p++) {
+		Paddle& paddle = vPaddle[p];
+		paddle.dir = input.paddleDir[p];
+		if (paddle.dir != 0 && !paddle.onScreen) {
+			paddle.onScreen = true;
+			goals = { 0, 0 };
+		}
+	}
+
+	// atualiza a posição da raquete
+	for(auto& paddle:vPaddle){
+		if (paddle.dir != 0)
+		{
+			// velocidade de 300 pixels por segundo
+			paddle.pos.x += paddle.dir * paddle.vel * deltaTime;
+			// verifique que a raquete n�o se move para fora da tela
+			// usamos "thickness", 
+			// que definimos como a altura dos elementos
+
+			if (paddle.pos.x < (paddle.width / 2.0f + thickness))
+			{
+				paddle.pos.x = paddle.width / 2.0f + thickness;
+			}
+			else if (
+				paddle.pos.x > (SCREEN_WIDTH - paddle.width*3.0f/2.0f - thickness))
+			{
+				paddle.pos.x = SCREEN_WIDTH - paddle.width*3.0f/2.0f - thickness;
+			}
+		}
+	}
+
+	// as bolas so se dividem se havia espaco no inicio do tick
+	// (a mesma regra para qualquer numero de threads)
+	bool canSplit = vBall.Size() < (size_t)config.maxBalls;
+
+	// cada worker cuida de uma faixa continua de bolas
+	size_t count = vBall.Size();
+	int workers = pool ? pool->Size() : 1;
+	if (count < (size_t)workers * min_balls_per_worker) {
+		workers = (int)(count / min_balls_per_worker);
+		if (workers < 1) workers = 1;
+	}
+	if (ballWork.size() < (size_t)workers) ballWork.resize(workers);
+
+	auto job = [&](int w) {
+		if (w >= workers) return;
+		size_t begin = count * w / workers;
+		size_t end = count * (w + 1) / workers;
+		ballWork[w].hits.clear();
+		ballWork[w].splits.clear();
+		ballWork[w].wallSplits.clear();
+		UpdateBalls(begin, end, deltaTime, canSplit, ballWork[w]);
+	};
+	if (workers > 1) pool->Run(job);
+	else job(0);
+
+	// juncao: as faixas estao na ordem das bolas, entao o resultado e o
+	// mesmo com 1 ou N threads
+	for (int w = 0; w < workers; w++) {
+		for (int index : ballWork[w].hits) {
+			HitBlock(index);
+		}
+	}
+	// divisoes por raquete/bloco de todas as bolas, depois as por parede,
+	// como no caso de uma thread so; a que nao cabe mais devolve as
+	// batidas a bola, que so as gasta quando divide de fato
+	for (int w = 0; w < workers; w++) {
+		for (auto const& split : ballWork[w].splits) {
+			if (vBall.Total() < (size_t)config.maxBalls) {
+				SpawnSplit(vBall, split.ball, split.vx, split.vy, splitRandom);
+			}
+			else {
+				vBall.taps[split.index] += split.ball.taps;
+			}
+		}
+	}
+	for (int w = 0; w < workers; w++) {
+		for (auto const& split : ballWork[w].wallSplits) {
+			if (vBall.Total() < (size_t)config.maxBalls) {
+				SpawnSplit(vBall, split.ball, split.vx, split.vy, splitRandom);
+			}
+			else {
+				vBall.taps[split.index] += split.ball.taps;
+			}
+		}
+	}
+
+	// tira as bolas que sairam por baixo e poe as que nasceram neste tick
+	vBall.RemoveDead();
+	vBall.FlushSpawns();
+}
+
+void Simulation::CopyFrom(const Simulation& other)
+{
+	int threads = config.threads;
+	config = other.config;
+	config.threads = threads;
+
+	tick = other.tick;
+	vBall.CopyFrom(other.vBall);
+	vPaddle.assign(other.vPaddle.begin(), other.vPaddle.end());
+	map = other.map;
+	vBlock.assign(other.vBlock.begin(), other.vBlock.end());
+	blockBoxes = other.blockBoxes;
+	blocksAlive = other.blocksAlive;
+	blocksDestroyed = other.blocksDestroyed;
+	// os blocos foram trocados: nao vale a versao da outra simulacao
+	blockVersion++;
+	goals.assign(other.goals.begin(), other.goals.end());
+	splitRandom = other.splitRandom;
+	stateHash = other.stateHash;
+	blockHash = other.blockHash;
+}
+
+void Simulation::HitBlock(int index)
+{
+	// tira a contribuicao antiga do bloco e soma a nova
+	Block& block = vBlock[index];
+	blockHash -= BlockHash(index, block);
+
+	block.taps += 1;
+	blockVersion++;
+	if (block.onScreen && block.taps > min_taps) {
+		block.onScreen = false;
+		blockBoxes.Clear(index);
+		blocksAlive--;
+		blocksDestroyed++;
+	}
+
+	blockHash += BlockHash(index, block);
+}
+
+void Simulation::UpdateHash()
+{
+	uint64_t h = HashWord(hash_k1, tick);
+
+	size_t count = vBall.Size();
+	h = HashWord(h, count);
+	h = HashBytes(h, vBall.posX.data(), count * sizeof(float));
+	h = HashBytes(h, vBall.posY.data(), count * sizeof(float));
+	h = HashBytes(h, vBall.velX.data(), count * sizeof(float));
+	h = HashBytes(h, vBall.velY.data(), count * sizeof(float));
+	h = HashBytes(h, vBall.taps.data(), count * sizeof(int));
+
+	for (auto const& paddle : vPaddle) {
+		h = HashBytes(h, &paddle.pos, sizeof(paddle.pos));
+		h = HashWord(h, static_cast<uint64_t>(paddle.dir) * 2 + paddle.onScreen);
+	}
+
+	h = HashWord(h, blockHash);
+	h = HashBytes(h, goals.data(), goals.size() * sizeof(int));
+
+	stateHash = Avalanche(h);
+}
@@ -0,0 +1,484 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "Collide.h"
+#include "Random.h"
+
+// Nucleo da simulacao (bolas, raquetes e blocos).
+// Nao depende do SDL: pode ser usado pelo Game ou por um executavel
+// headless, sem janela e sem renderizador.
+
+#define SCREEN_HEIGHT 480
+#define SCREEN_WIDTH 640
+
+const int min_taps = 3;
+
+const int max_balls = 3;
+
+const int max_paddles = 2;
+
+//sera usado para setar a altura de alguns objetos
+const int thickness = 15;
+
+// Vector2 struct just stores x/y coordinates
+// (for now)
+struct Vector2
+{
+	float x;
+	float y;
+};
+
+class Ball {
+public:
+	Vector2 pos;
+	// posicao no tick anterior, usada para interpolar o desenho
+	Vector2 prev;
+	Vector2 vel;
+	Vector2 acc;
+	float width;
+	float height;
+	bool onScreen;
+	int taps;
+
+	Ball(float x, float y, float vx, float vy, float w, float h)
+		:pos({x, y}), prev({x, y}), vel({vx, vy}), height(h), width(w), taps(0)
+	{
+		onScreen = true;
+		acc = { 0.00f * fabsf(vx), 0.00f * fabsf(vy) };
+	}
+
+	bool collide(Vector2 o_pos, float o_width, float o_height){
+		return ((pos.x < o_pos.x + o_width && o_pos.x < pos.x + width)
+			&& (pos.y < o_pos.y + o_height && o_pos.y < pos.y + height));
+	}
+
+};
+
+// Bolas guardadas como estrutura de vetores (um vetor por campo),
+// para que as passadas de movimento e de paredes sejam lineares.
+// Todas as bolas tem thickness x thickness.
+class BallStore {
+public:
+	std::vector<float> posX;
+	std::vector<float> posY;
+	std::vector<float> prevX;
+	std::vector<float> prevY;
+	std::vector<float> velX;
+	std::vector<float> velY;
+	std::vector<float> accX;
+	std::vector<float> accY;
+	std::vector<int> taps;
+	std::vector<unsigned char> alive;
+
+	// rascunho do Step: bola bateu numa parede lateral / de cima
+	std::vector<unsigned char> bounceX;
+	std::vector<unsigned char> bounceY;
+	// rascunho do Step: o caminho da bola pode tocar raquete ou bloco
+	std::vector<unsigned char> sweep;
+
+	// bolas criadas durante o tick; entram com FlushSpawns
+	std::vector<Ball> spawn;
+
+	// bolas ativas
+	size_t Size() const { return posX.size(); }
+	bool Empty() const { return posX.empty(); }
+	// ativas mais as que vao nascer no fim do tick
+	size_t Total() const { return posX.size() + spawn.size(); }
+
+	// reserva espaco para n bolas, para nao realocar durante a partida
+	void Reserve(size_t n) {
+		posX.reserve(n); posY.reserve(n);
+		prevX.reserve(n); prevY.reserve(n);
+		velX.reserve(n); velY.reserve(n);
+		accX.reserve(n); accY.reserve(n);
+		taps.reserve(n); alive.reserve(n);
+		bounceX.reserve(n); bounceY.reserve(n);
+		sweep.reserve(n);
+		spawn.reserve(n);
+	}
+
+	void Clear() {
+		posX.clear(); posY.clear();
+		prevX.clear(); prevY.clear();
+		velX.clear(); velY.clear();
+		accX.clear(); accY.clear();
+		taps.clear(); alive.clear();
+		bounceX.clear(); bounceY.clear();
+		sweep.clear();
+		spawn.clear();
+	}
+
+	void Add(const Ball& b) {
+		posX.push_back(b.pos.x); posY.push_back(b.pos.y);
+		prevX.push_back(b.prev.x); prevY.push_back(b.prev.y);
+		velX.push_back(b.vel.x); velY.push_back(b.vel.y);
+		accX.push_back(b.acc.x); accY.push_back(b.acc.y);
+		taps.push_back(b.taps);
+		alive.push_back(b.onScreen);
+		bounceX.push_back(0); bounceY.push_back(0);
+		sweep.push_back(0);
+	}
+
+	Ball Get(size_t i) const {
+		Ball b(posX[i], posY[i], velX[i], velY[i], thickness, thickness);
+		b.prev = { prevX[i], prevY[i] };
+		b.acc = { accX[i], accY[i] };
+		b.taps = taps[i];
+		b.onScreen = alive[i] != 0;
+		return b;
+	}
+
+	void Set(size_t i, const Ball& b) {
+		posX[i] = b.pos.x; posY[i] = b.pos.y;
+		prevX[i] = b.prev.x; prevY[i] = b.prev.y;
+		velX[i] = b.vel.x; velY[i] = b.vel.y;
+		accX[i] = b.acc.x; accY[i] = b.acc.y;
+		taps[i] = b.taps;
+		alive[i] = b.onScreen;
+	}
+
+	// remove em O(1): a ultima bola ocupa o lugar da removida
+	void Remove(size_t i) {
+		size_t last = Size() - 1;
+		if (i != last) {
+			posX[i] = posX[last]; posY[i] = posY[last];
+			prevX[i] = prevX[last]; prevY[i] = prevY[last];
+			velX[i] = velX[last]; velY[i] = velY[last];
+			accX[i] = accX[last]; accY[i] = accY[last];
+			taps[i] = taps[last];
+			alive[i] = alive[last];
+			bounceX[i] = bounceX[last]; bounceY[i] = bounceY[last];
+			sweep[i] = sweep[last];
+		}
+		posX.pop_back(); posY.pop_back();
+		prevX.pop_back(); prevY.pop_back();
+		velX.pop_back(); velY.pop_back();
+		accX.pop_back(); accY.pop_back();
+		taps.pop_back(); alive.pop_back();
+		bounceX.pop_back(); bounceY.pop_back();
+		sweep.pop_back();
+	}
+
+	void RemoveDead() {
+		size_t i = 0;
+		while (i < Size()) {
+			if (!alive[i]) Remove(i);
+			else i++;
+		}
+	}
+
+	void Spawn(const Ball& b) { spawn.push_back(b); }
+
+	void FlushSpawns() {
+		for (auto const& b : spawn) Add(b);
+		spawn.clear();
+	}
+
+	// copia as bolas de o (sem o rascunho do Step); nao aloca se a
+	// capacidade destes vetores ja basta
+	void CopyFrom(const BallStore& o) {
+		posX.assign(o.posX.begin(), o.posX.end());
+		posY.assign(o.posY.begin(), o.posY.end());
+		prevX.assign(o.prevX.begin(), o.prevX.end());
+		prevY.assign(o.prevY.begin(), o.prevY.end());
+		velX.assign(o.velX.begin(), o.velX.end());
+		velY.assign(o.velY.begin(), o.velY.end());
+		accX.assign(o.accX.begin(), o.accX.end());
+		accY.assign(o.accY.begin(), o.accY.end());
+		taps.assign(o.taps.begin(), o.taps.end());
+		alive.assign(o.alive.begin(), o.alive.end());
+		bounceX.resize(o.Size());
+		bounceY.resize(o.Size());
+		sweep.resize(o.Size());
+		spawn.clear();
+	}
+};
+
+class Paddle {
+public:
+	Vector2 pos;
+	Vector2 prev;
+	float width;
+	float height;
+	float vel;
+	int dir;
+	bool onScreen;
+//	int goals_taken;
+
+	Paddle(float x, float y, float w, float h, float v, bool show = true)
+		:pos({x, y}), prev({x, y}), width(w), height(h), vel(v), dir(0), onScreen(show)
+	{
+		//constructor
+	}
+
+//	bool collide()
+
+};
+
+//Block class
+class Block {
+public:
+	Vector2 pos;
+	float height;
+	float width;
+	bool onScreen;
+	int taps;
+
+	Block(float x, float y, float w, float h, bool show = true)
+		:pos({ x, y }), height(h), width(w), onScreen(show), taps(0)
+	{
+		//constructor
+	}
+
+};
+
+//Blockmap class
+class BlockMap {
+//private:
+//	std::vector<std::vector<int>> matrix;
+
+public:
+	std::vector<std::vector<int>> matrix;
+	float windowWidth;
+	float windowHeight;
+
+	float matrixWidth;
+	float matrixHeight;
+
+	// canto superior esquerdo do mapa na tela e tamanho de cada celula
+	float left;
+	float top;
+	float cellWidth;
+	float cellHeight;
+
+	BlockMap(): windowWidth(0), windowHeight(0), matrixWidth(0), matrixHeight(0),
+		left(0), top(0), cellWidth(0), cellHeight(0)
+	{
+	
+	}
+	BlockMap(float w_width, float w_height, int m_width, int m_height, float m_left = 0, float m_top = 0)
+		: windowWidth(w_width), windowHeight(w_height), matrixWidth(m_width), matrixHeight(m_height),
+		left(m_left), top(m_top), cellWidth(w_width / m_width), cellHeight(w_height / m_height)
+	{
+		matrix.resize(m_height);
+
+		for (auto& row : matrix) {
+			row.resize(m_width, 1);
+		}
+
+		//matrix[0].resize(m_width, 0);
+		//matrix[1] = { 0,1,1,0,1,1,0 };
+		//matrix[2].resize(m_width, 0);
+		//matrix[3] = { 0,0,1,1,1,0,0 };
+		//matrix[4].resize(m_width, 0);
+	}
+
+	int Columns() const { return static_cast<int>(matrixWidth); }
+	int Rows() const { return static_cast<int>(matrixHeight); }
+
+	// indice da celula (linha, coluna) num vetor linha a linha
+	int Index(int row, int col) const { return row * Columns() + col; }
+
+	// Celulas cobertas pelo retangulo (x, y, w, h), ja limitadas ao mapa.
+	// Retorna false se o retangulo esta todo fora do mapa.
+	bool CellRange(float x, float y, float w, float h,
+		int& row0, int& col0, int& row1, int& col1) const
+	{
+		if (cellWidth <= 0 || cellHeight <= 0) return false;
+		// teste barato antes das divisoes: a maioria das bolas esta fora do mapa
+		if (x + w < left || y + h < top
+			|| x >= left + windowWidth || y >= top + windowHeight) return false;
+
+		col0 = static_cast<int>(floorf((x - left) / cellWidth));
+		col1 = static_cast<int>(floorf((x + w - left) / cellWidth));
+		row0 = static_cast<int>(floorf((y - top) / cellHeight));
+		row1 = static_cast<int>(floorf((y + h - top) / cellHeight));
+
+		if (col1 < 0 || row1 < 0 || col0 >= Columns() || row0 >= Rows()) return false;
+
+		if (col0 < 0) col0 = 0;
+		if (row0 < 0) row0 = 0;
+		if (col1 >= Columns()) col1 = Columns() - 1;
+		if (row1 >= Rows()) row1 = Rows() - 1;
+		return true;
+	}
+
+	void Initialize(){
+	}
+
+};
+
+// Parametros de uma partida
+struct SimConfig
+{
+	// tamanho do mapa de blocos
+	int columns;
+	int rows;
+	// limite de bolas simultaneas (as bolas se dividem ate ele)
+	int maxBalls;
+	// parede de baixo fechada: as bolas quicam em vez de sair
+	bool closedBottom;
+	// threads usadas na atualizacao das bolas (o resultado e o mesmo
+	// para qualquer valor)
+	int threads;
+	// semente dos sorteios; a mesma semente repete a partida
+	uint64_t seed;
+
+	SimConfig(): columns(7), rows(5), maxBalls(max_balls), closedBottom(false), threads(1), seed(1) {}
+};
+
+// Entrada de um tick da simulacao: direcao de cada raquete
+// (-1 esquerda, 0 parada, +1 direita)
+struct SimInput
+{
+	int paddleDir[max_paddles];
+};
+
+// Pedido de divisao: nova bola na posicao de ball com velocidade (vx, vy).
+// ball.taps guarda as batidas zeradas pelo pedido, devolvidas a bola
+// index se a juncao nao criar a bola
+struct SplitRequest
+{
+	Ball ball;
+	size_t index;
+	float vx;
+	float vy;
+
+	SplitRequest(const Ball& b, size_t i, float v_x, float v_y): ball(b), index(i), vx(v_x), vy(v_y) {}
+};
+
+// Resultado de uma faixa de bolas, aplicado depois na ordem das bolas
+struct BallWork
+{
+	// indices (em vBlock) dos blocos atingidos
+	std::vector<int> hits;
+	// divisoes por raquete ou bloco, e por parede
+	std::vector<SplitRequest> splits;
+	std::vector<SplitRequest> wallSplits;
+};
+
+// -1, 0 ou +1 conforme o sinal de n
+float get_sign(float n);
+
+class WorkerPool;
+
+// Simulation class
+class Simulation
+{
+public:
+	Simulation();
+	// Copias tem o estado e o numero de threads do original, mas cada
+	// uma com o seu pool: WorkerPool::Run nao e reentrante, entao duas
+	// simulacoes andando em threads diferentes nao podem dividir um
+	Simulation(const Simulation& other);
+	Simulation& operator=(const Simulation& other);
+	~Simulation();
+	// Monta o estado inicial (raquete, bola e mapa de blocos)
+	void Initialize(const SimConfig& config = SimConfig());
+	// Avanca a simulacao em deltaTime segundos
+	void Step(float deltaTime, const SimInput& input);
+	// Repete a mesma entrada por ate ticks ticks (frame skip), parando
+	// antes se a ultima bola sair; o hash so e calculado no fim. O estado
+	// final e o mesmo de chamar Step o mesmo numero de vezes. Devolve
+	// quantos ticks foram dados.
+	int StepRepeat(float deltaTime, const SimInput& input, int ticks);
+	// Avanca seconds segundos pulando de colisao em colisao (EventSim.cpp);
+	// as raquetes ficam paradas durante o intervalo
+	void AdvanceEvents(float seconds);
+	// Primeiro bloco vivo que a caixa (x, y, w, h) atinge andando com
+	// velocidade (vx, vy) em ate maxTime segundos, ou -1 se nenhum;
+	// time e o instante do contato e hitX diz se a face e lateral
+	int SweepBlocks(float x, float y, float w, float h, float vx, float vy,
+		float maxTime, float& time, bool& hitX) const;
+	// Verdadeiro quando todas as bolas sairam pela parede de baixo
+	bool IsOver() const { return vBall.Empty(); }
+	// Hash do estado (bolas, raquetes, blocos, placar e tick): duas
+	// simulacoes com o mesmo hash estao, na pratica, no mesmo estado.
+	// Calculado uma vez no fim de cada Step; a parte dos blocos e
+	// atualizada so quando um bloco muda
+	uint64_t Hash() const { return stateHash; }
+	// Uma batida no bloco index (em vBlock): conta a batida e destroi
+	// o bloco depois de min_taps batidas
+	void HitBlock(int index);
+
+	// Copia o estado de other: bolas, raquetes, blocos, mapa, placar,
+	// sorteador e tick (as threads continuam as deste objeto).
+	// Nao aloca memoria quando este objeto ja guardou um estado do
+	// mesmo tamanho, entao copias repetidas custam so os memcpy
+	void CopyFrom(const Simulation& other);
+
+	// Snapshot binario do estado, para guardar em disco (Snapshot.cpp)
+	void SaveSnapshot(std::vector<unsigned char>& out) const;
+	// false se os dados nao sao um snapshot valido (o estado fica
+	// indefinido; chame Initialize ou carregue outro)
+	bool LoadSnapshot(const unsigned char* data, size_t size);
+	bool SaveSnapshotFile(const char* path) const;
+	bool LoadSnapshotFile(const char* path);
+
+	SimConfig config;
+
+	// ticks (chamadas de Step) desde o Initialize
+	uint64_t tick;
+
+	// Pong specific
+	BallStore vBall;
+
+	std::vector<Paddle> vPaddle;
+
+	BlockMap map;
+
+	// um bloco por celula do mapa, linha a linha (map.Index);
+	// blocos destruidos ficam com onScreen = false
+	std::vector<Block> vBlock;
+
+	// caixas dos blocos na mesma ordem de vBlock, para o teste em lote;
+	// bloco destruido fica com caixa vazia
+	BoxArrays blockBoxes;
+
+	// blocos ainda na tela e blocos destruidos desde o Initialize
+	int blocksAlive;
+	int blocksDestroyed;
+	// muda sempre que algum bloco muda (acerto, destruicao, mapa novo),
+	// para quem guarda algo desenhado a partir dos blocos
+	uint64_t blockVersion;
+
+	//int taps;
+
+	//int goals_left;
+	std::vector<int> goals;
+
+	// sorteios da divisao de bolas (fluxo STREAM_SPLIT de config.seed)
+	Random splitRandom;
+
+private:
+	// um tick do Step, sem o hash
+	void Advance(float deltaTime, const SimInput& input);
+	void UpdateHash();
+	// refaz blockBoxes, as contagens e a parte do hash dos blocos
+	// a partir de vBlock
+	void RebuildBlockState();
+	// (re)cria o pool para config.threads, se o numero mudou
+	void CreatePool();
+
+	void UpdateBalls(size_t begin, size_t end, float deltaTime, bool canSplit, BallWork& work);
+
+	// threads para atualizar as bolas (nulo com config.threads <= 1);
+	// cada simulacao tem o seu, nunca dividido com as copias
+	std::unique_ptr<WorkerPool> pool;
+	// um resultado por worker, reaproveitado a cada tick
+	std::vector<BallWork> ballWork;
+
+	// hash do ultimo tick e soma das contribuicoes de cada bloco
+	uint64_t stateHash;
+	uint64_t blockHash;
+};
@@ -0,0 +1,241 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+// Snapshot do estado da simulacao (binario, little-endian):
+//   "ARKS", versao
+//   SimConfig (colunas, linhas, maxBalls, closedBottom, semente),
+//   tick, estado do sorteador
+//   bolas (um vetor por campo, como no BallStore)
+//   raquetes, mapa de blocos (dimensoes e matriz), blocos, placar
+//   hash do estado, conferido ao carregar
+// As caixas dos blocos e a parte do hash dos blocos nao sao gravadas:
+// sao refeitas a partir dos blocos.
+
+#include "Simulation.h"
+#include "BinaryIO.h"
+#include <cstdio>
+
+static const char snapshot_magic[4] = { 'A', 'R', 'K', 'S' };
+const uint32_t snapshot_version = 1;
+
+static void WriteFloats(ByteWriter& out, const std::vector<float>& v)
+{
+	for (float f : v) out.F32(f);
+}
+
+static void ReadFloats(ByteReader& in, std::vector<float>& v, size_t count)
+{
+	v.resize(count);
+	for (size_t i = 0; i < count; i++) v[i] = in.F32();
+}
+
+static void WriteVector2(ByteWriter& out, const Vector2& v)
+{
+	out.F32(v.x);
+	out.F32(v.y);
+}
+
+static Vector2 ReadVector2(ByteReader& in)
+{
+	Vector2 v;
+	v.x = in.F32();
+	v.y = in.F32();
+	return v;
+}
+
+void Simulation::SaveSnapshot(std::vector<unsigned char>& buffer) const
+{
+	buffer.clear();
+	ByteWriter out(buffer);
+
+	out.Bytes(snapshot_magic, 4);
+	out.U32(snapshot_version);
+
+	out.I32(config.columns);
+	out.I32(config.rows);
+	out.I32(config.maxBalls);
+	out.U8(config.closedBottom ? 1 : 0);
+	out.U64(config.seed);
+
+	out.U64(tick);
+	out.U64(splitRandom.state);
+	out.U64(splitRandom.inc);
+
+	out.U32(static_cast<uint32_t>(vBall.Size()));
+	WriteFloats(out, vBall.posX);
+	WriteFloats(out, vBall.posY);
+	WriteFloats(out, vBall.prevX);
+	WriteFloats(out, vBall.prevY);
+	WriteFloats(out, vBall.velX);
+	WriteFloats(out, vBall.velY);
+	WriteFloats(out, vBall.accX);
+	WriteFloats(out, vBall.accY);
+	for (int t : vBall.taps) out.I32(t);
+	for (unsigned char a : vBall.alive) out.U8(a);
+
+	out.U32(static_cast<uint32_t>(vPaddle.size()));
+	for (auto const& paddle : vPaddle) {
+		WriteVector2(out, paddle.pos);
+		WriteVector2(out, paddle.prev);
+		out.F32(paddle.width);
+		out.F32(paddle.height);
+		out.F32(paddle.vel);
+		out.I32(paddle.dir);
+		out.U8(paddle.onScreen ? 1 : 0);
+	}
+
+	out.F32(map.windowWidth);
+	out.F32(map.windowHeight);
+	out.I32(map.Columns());
+	out.I32(map.Rows());
+	out.F32(map.left);
+	out.F32(map.top);
+	for (auto const& row : map.matrix) {
+		for (int cell : row) out.I32(cell);
+	}
+
+	out.U32(static_cast<uint32_t>(vBlock.size()));
+	for (auto const& block : vBlock) {
+		WriteVector2(out, block.pos);
+		out.F32(block.width);
+		out.F32(block.height);
+		out.I32(block.taps);
+		out.U8(block.onScreen ? 1 : 0);
+	}
+
+	out.U32(static_cast<uint32_t>(goals.size()));
+	for (int g : goals) out.I32(g);
+
+	out.U64(stateHash);
+}
+
+bool Simulation::LoadSnapshot(const unsigned char* data, size_t size)
+{
+	ByteReader in(data, size);
+
+	char magic[4];
+	in.Bytes(magic, 4);
+	if (!in.Ok() || memcmp(magic, snapshot_magic, 4) != 0 || in.U32() != snapshot_version) {
+		return false;
+	}
+
+	config.columns = in.I32();
+	config.rows = in.I32();
+	config.maxBalls = in.I32();
+	config.closedBottom = in.U8() != 0;
+	config.seed = in.U64();
+	if (config.maxBalls < 1) return false;
+
+	tick = in.U64();
+	splitRandom.state = in.U64();
+	splitRandom.inc = in.U64();
+
+	// contagens sao conferidas contra o tamanho dos dados antes de alocar
+	size_t balls = in.U32();
+	if (!in.Ok() || in.Remaining() / (8 * 4 + 4 + 1) < balls) return false;
+	vBall.Clear();
+	vBall.Reserve(balls);
+	ReadFloats(in, vBall.posX, balls);
+	ReadFloats(in, vBall.posY, balls);
+	ReadFloats(in, vBall.prevX, balls);
+	ReadFloats(in, vBall.prevY, balls);
+	ReadFloats(in, vBall.velX, balls);
+	ReadFloats(in, vBall.velY, balls);
+	ReadFloats(in, vBall.accX, balls);
+	ReadFloats(in, vBall.accY, balls);
+	vBall.taps.resize(balls);
+	for (size_t i = 0; i < balls; i++) vBall.taps[i] = in.I32();
+	vBall.alive.resize(balls);
+	for (size_t i = 0; i < balls; i++) vBall.alive[i] = in.U8();
+	vBall.bounceX.assign(balls, 0);
+	vBall.bounceY.assign(balls, 0);
+	vBall.sweep.assign(balls, 0);
+
+	size_t paddles = in.U32();
+	if (!in.Ok() || in.Remaining() / (8 * 4 + 1) < paddles) return false;
+	vPaddle.clear();
+	for (size_t p = 0; p < paddles; p++) {
+		Paddle paddle(0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+		paddle.pos = ReadVector2(in);
+		paddle.prev = ReadVector2(in);
+		paddle.width = in.F32();
+		paddle.height = in.F32();
+		paddle.vel = in.F32();
+		paddle.dir = in.I32();
+		paddle.onScreen = in.U8() != 0;
+		vPaddle.push_back(paddle);
+	}
+
+	float windowWidth = in.F32();
+	float windowHeight = in.F32();
+	int columns = in.I32();
+	int rows = in.I32();
+	float left = in.F32();
+	float top = in.F32();
+	if (!in.Ok() || columns <= 0 || rows <= 0
+		|| in.Remaining() / 4 / (size_t)columns < (size_t)rows) return false;
+	map = BlockMap(windowWidth, windowHeight, columns, rows, left, top);
+	for (auto& row : map.matrix) {
+		for (int& cell : row) cell = in.I32();
+	}
+
+	size_t blocks = in.U32();
+	if (!in.Ok() || blocks != map.matrix.size() * (size_t)columns
+		|| in.Remaining() / (5 * 4 + 1) < blocks) return false;
+	vBlock.clear();
+	vBlock.reserve(blocks);
+	for (size_t k = 0; k < blocks; k++) {
+		Vector2 pos = ReadVector2(in);
+		float width = in.F32();
+		float height = in.F32();
+		Block block(pos.x, pos.y, width, height, true);
+		block.taps = in.I32();
+		block.onScreen = in.U8() != 0;
+		vBlock.push_back(block);
+	}
+
+	size_t goalCount = in.U32();
+	if (!in.Ok() || in.Remaining() / 4 < goalCount) return false;
+	goals.resize(goalCount);
+	for (size_t g = 0; g < goalCount; g++) goals[g] = in.I32();
+
+	uint64_t savedHash = in.U64();
+	if (!in.Ok()) return false;
+
+	RebuildBlockState();
+	UpdateHash();
+
+	return stateHash == savedHash;
+}
+
+bool Simulation::SaveSnapshotFile(const char* path) const
+{
+	std::vector<unsigned char> buffer;
+	SaveSnapshot(buffer);
+
+	FILE* file = fopen(path, "wb");
+	if (!file) return false;
+	bool ok = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+	return fclose(file) == 0 && ok;
+}
+
+bool Simulation::LoadSnapshotFile(const char* path)
+{
+	FILE* file = fopen(path, "rb");
+	if (!file) return false;
+
+	std::vector<unsigned char> buffer;
+	unsigned char chunk[4096];
+	size_t n;
+	while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+		buffer.insert(buffer.end(), chunk, chunk + n);
+	}
+	fclose(file);
+
+	return LoadSnapshot(buffer.data(), buffer.size());
+}
@@ -0,0 +1,199 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "SpriteSheet.h"
+
+#include "SOIL/SOIL.h"
+#include "rapidjson/document.h"
+
+#include "Simulation.h"
+
+// blocos aguentam min_taps + 1 batidas (Simulation::HitBlock)
+const int block_hits = min_taps + 1;
+
+SpriteSheet::SpriteSheet()
+	:mWall(-1)
+	,mPaddle(-1)
+	,mBall(-1)
+	,mPixels(nullptr)
+	,mWidth(0)
+	,mHeight(0)
+	,mLoaded(false)
+{
+}
+
+SpriteSheet::~SpriteSheet()
+{
+	FreePixels();
+}
+
+void SpriteSheet::FreePixels()
+{
+	if (mPixels) SOIL_free_image_data(mPixels);
+	mPixels = nullptr;
+}
+
+void SpriteSheet::Clear()
+{
+	FreePixels();
+	mNames.clear();
+	mRects.clear();
+	mBlocks.clear();
+	mWall = mPaddle = mBall = -1;
+	mWidth = mHeight = 0;
+	mLoaded = false;
+}
+
+int SpriteSheet::Find(const char* name) const
+{
+	for (size_t k = 0; k < mNames.size(); k++) {
+		if (mNames[k] == name) return static_cast<int>(k);
+	}
+	return -1;
+}
+
+int SpriteSheet::Block(int taps) const
+{
+	int left = block_hits - taps;
+	if (left < 1) left = 1;
+	if (left > static_cast<int>(mBlocks.size())) left = static_cast<int>(mBlocks.size());
+	return mBlocks[left - 1];
+}
+
+bool SpriteSheet::Parse(const std::string& json, std::string& image)
+{
+	rapidjson::Document doc;
+	doc.Parse(json.c_str());
+	if (doc.HasParseError() || !doc.IsObject())
+	{
+		SDL_Log("Sprite sheet: JSON invalido (offset %u)", (unsigned)doc.GetErrorOffset());
+		return false;
+	}
+
+	auto meta = doc.FindMember("meta");
+	if (meta == doc.MemberEnd() || !meta->value.IsObject() ||
+		!meta->value.HasMember("image") || !meta->value["image"].IsString())
+	{
+		SDL_Log("Sprite sheet: falta meta.image");
+		return false;
+	}
+	image = meta->value["image"].GetString();
+
+	auto frames = doc.FindMember("frames");
+	if (frames == doc.MemberEnd() || !frames->value.IsObject())
+	{
+		SDL_Log("Sprite sheet: falta frames");
+		return false;
+	}
+
+	for (auto it = frames->value.MemberBegin(); it != frames->value.MemberEnd(); ++it) {
+		const rapidjson::Value& sprite = it->value;
+		if (!sprite.IsObject() || !sprite.HasMember("frame")) continue;
+		const rapidjson::Value& frame = sprite["frame"];
+		const char* keys[4] = { "x", "y", "w", "h" };
+		int v[4] = { 0, 0, 0, 0 };
+		bool ok = frame.IsObject();
+		for (int k = 0; k < 4 && ok; k++) {
+			ok = frame.HasMember(keys[k]) && frame[keys[k]].IsInt();
+			if (ok) v[k] = frame[keys[k]].GetInt();
+		}
+		if (!ok)
+		{
+			SDL_Log("Sprite sheet: frame invalido em %s", it->name.GetString());
+			return false;
+		}
+		mNames.push_back(it->name.GetString());
+		mRects.push_back(SDL_Rect{ v[0], v[1], v[2], v[3] });
+	}
+	return true;
+}
+
+bool SpriteSheet::Load(const char* jsonPath)
+{
+	Clear();
+
+	// o JSON inteiro de uma vez (SDL_RWops, como o resto do jogo)
+	SDL_RWops* file = SDL_RWFromFile(jsonPath, "rb");
+	if (!file)
+	{
+		SDL_Log("Sprite sheet: nao abriu %s", jsonPath);
+		return false;
+	}
+	Sint64 size = SDL_RWsize(file);
+	std::string json(size > 0 ? static_cast<size_t>(size) : 0, '\0');
+	size_t read = size > 0 ? SDL_RWread(file, &json[0], 1, json.size()) : 0;
+	SDL_RWclose(file);
+	if (size <= 0 || read != json.size())
+	{
+		SDL_Log("Sprite sheet: nao leu %s", jsonPath);
+		return false;
+	}
+
+	std::string image;
+	if (!Parse(json, image))
+	{
+		Clear();
+		return false;
+	}
+
+	mWall = Find("wall");
+	mPaddle = Find("paddle");
+	mBall = Find("ball");
+
+	// block_N para cada N de 1 ate block_hits; os que faltam usam o
+	// vizinho definido mais proximo (de preferencia com menos batidas)
+	std::vector<int> defined(block_hits, -1);
+	for (int n = 1; n <= block_hits; n++) {
+		char name[32];
+		SDL_snprintf(name, sizeof(name), "block_%d", n);
+		defined[n - 1] = Find(name);
+	}
+	for (int n = 0; n < block_hits; n++) {
+		int best = -1;
+		for (int d = 0; d < block_hits && best < 0; d++) {
+			if (n - d >= 0 && defined[n - d] >= 0) best = defined[n - d];
+			else if (n + d < block_hits && defined[n + d] >= 0) best = defined[n + d];
+		}
+		mBlocks.push_back(best);
+	}
+
+	if (mWall < 0 || mPaddle < 0 || mBall < 0 || mBlocks[0] < 0)
+	{
+		SDL_Log("Sprite sheet: %s precisa de wall, paddle, ball e block_N", jsonPath);
+		Clear();
+		return false;
+	}
+
+	// a imagem fica ao lado do JSON
+	std::string path = jsonPath;
+	size_t slash = path.find_last_of("/\\");
+	path = (slash == std::string::npos ? std::string() : path.substr(0, slash + 1)) + image;
+
+	int channels = 0;
+	mPixels = SOIL_load_image(path.c_str(), &mWidth, &mHeight, &channels, SOIL_LOAD_RGBA);
+	if (!mPixels)
+	{
+		SDL_Log("Sprite sheet: nao carregou %s: %s", path.c_str(), SOIL_last_result());
+		Clear();
+		return false;
+	}
+
+	// sprites fora da imagem seriam lixo na tela
+	for (size_t k = 0; k < mRects.size(); k++) {
+		const SDL_Rect& r = mRects[k];
+		if (r.x < 0 || r.y < 0 || r.w <= 0 || r.h <= 0 || r.x + r.w > mWidth || r.y + r.h > mHeight)
+		{
+			SDL_Log("Sprite sheet: %s fora da imagem", mNames[k].c_str());
+			Clear();
+			return false;
+		}
+	}
+
+	mLoaded = true;
+	return true;
+}
@@ -0,0 +1,74 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <string>
+#include <vector>
+
+#include "SDL/SDL.h"
+
+// Sprites de paredes, raquetes, bolas e blocos numa imagem so (carregada
+// pelo SOIL) descrita por um JSON no formato "hash" do TexturePacker:
+//
+//	{ "frames": { "ball": { "frame": { "x": 0, "y": 0, "w": 15, "h": 15 } }, ... },
+//	  "meta": { "image": "Sprites.png" } }
+//
+// O caminho da imagem e relativo ao do JSON. Os blocos usam "block_N",
+// com N as batidas que ainda faltam para o bloco sumir; sem o sprite
+// daquele N, vale o N mais proximo.
+//
+// Os pixels ficam na memoria so ate os renderizadores criarem suas
+// texturas (FreePixels); os retangulos continuam valendo.
+class SpriteSheet
+{
+public:
+	SpriteSheet();
+	~SpriteSheet();
+
+	SpriteSheet(const SpriteSheet&) = delete;
+	SpriteSheet& operator=(const SpriteSheet&) = delete;
+
+	// Le o JSON e a imagem; false (e nada carregado) se faltar algo
+	bool Load(const char* jsonPath);
+	void FreePixels();
+
+	// tem todos os sprites (o jogo desenha cores solidas sem eles)
+	bool IsLoaded() const { return mLoaded; }
+
+	// RGBA, 4 bytes por pixel, linhas sem espaco entre si
+	const unsigned char* Pixels() const { return mPixels; }
+	int Width() const { return mWidth; }
+	int Height() const { return mHeight; }
+
+	// indice do sprite name, ou -1
+	int Find(const char* name) const;
+	const SDL_Rect& Rect(int sprite) const { return mRects[sprite]; }
+
+	int Wall() const { return mWall; }
+	int Paddle() const { return mPaddle; }
+	int Ball() const { return mBall; }
+	// sprite de um bloco que ja levou taps batidas
+	int Block(int taps) const;
+
+private:
+	bool Parse(const std::string& json, std::string& image);
+	void Clear();
+
+	std::vector<std::string> mNames;
+	std::vector<SDL_Rect> mRects;
+	// sprite por batidas restantes - 1
+	std::vector<int> mBlocks;
+	int mWall;
+	int mPaddle;
+	int mBall;
+
+	unsigned char* mPixels;
+	int mWidth;
+	int mHeight;
+	bool mLoaded;
+};
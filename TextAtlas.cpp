@@ -0,0 +1,143 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "TextAtlas.h"
+
+// largura maxima de uma linha do atlas
+const int atlas_width = 512;
+
+TextAtlas::TextAtlas()
+	:mTexture(nullptr)
+	,mLineHeight(0)
+{
+	for (int g = 0; g < glyph_count; g++) mGlyphs[g] = SDL_Rect{ 0, 0, 0, 0 };
+}
+
+TextAtlas::~TextAtlas()
+{
+	Destroy();
+}
+
+void TextAtlas::Destroy()
+{
+	if (mTexture) SDL_DestroyTexture(mTexture);
+	mTexture = nullptr;
+}
+
+bool TextAtlas::Build(SDL_Renderer* renderer, TTF_Font* font)
+{
+	Destroy();
+
+	SDL_Surface* atlas = BuildSurface(font);
+	if (!atlas) return false;
+
+	mTexture = SDL_CreateTextureFromSurface(renderer, atlas);
+	SDL_FreeSurface(atlas);
+	if (!mTexture) return false;
+
+	SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
+	return true;
+}
+
+SDL_Surface* TextAtlas::BuildSurface(TTF_Font* font)
+{
+	if (!font) return nullptr;
+
+	// glifos brancos; a cor do texto vem de SDL_SetTextureColorMod
+	SDL_Color white = { 255, 255, 255, 255 };
+	SDL_Surface* glyphs[glyph_count] = { nullptr };
+
+	// primeiro rasteriza tudo e arruma em linhas, para saber o tamanho
+	int x = 0, y = 0, rowHeight = 0;
+	bool ok = true;
+	for (int g = 0; g < glyph_count && ok; g++) {
+		char text[2] = { static_cast<char>(first_glyph + g), '\0' };
+		glyphs[g] = TTF_RenderText_Solid(font, text, white);
+		if (!glyphs[g]) {
+			ok = false;
+			break;
+		}
+
+		int w = glyphs[g]->w, h = glyphs[g]->h;
+		if (x + w > atlas_width) {
+			x = 0;
+			y += rowHeight;
+			rowHeight = 0;
+		}
+		mGlyphs[g] = SDL_Rect{ x, y, w, h };
+		x += w;
+		if (h > rowHeight) rowHeight = h;
+	}
+
+	SDL_Surface* atlas = nullptr;
+	if (ok) {
+		atlas = SDL_CreateRGBSurface(0, atlas_width, y + rowHeight, 32,
+			0xFF000000, 0x00FF0000, 0x0000FF00, 0x000000FF);
+		ok = atlas != nullptr;
+	}
+	if (ok) {
+		// fundo transparente; o colorkey do Solid deixa o fundo de
+		// cada glifo de fora e o resto e copiado opaco
+		SDL_FillRect(atlas, nullptr, SDL_MapRGBA(atlas->format, 0, 0, 0, 0));
+		for (int g = 0; g < glyph_count; g++) {
+			SDL_SetSurfaceBlendMode(glyphs[g], SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(glyphs[g], nullptr, atlas, &mGlyphs[g]);
+		}
+		mLineHeight = TTF_FontLineSkip(font);
+	}
+
+	for (int g = 0; g < glyph_count; g++) {
+		if (glyphs[g]) SDL_FreeSurface(glyphs[g]);
+	}
+	if (!ok && atlas) {
+		SDL_FreeSurface(atlas);
+		atlas = nullptr;
+	}
+	return atlas;
+}
+
+const SDL_Rect& TextAtlas::Glyph(char c) const
+{
+	int g = static_cast<unsigned char>(c) - first_glyph;
+	if (g < 0 || g >= glyph_count) g = '?' - first_glyph;
+	return mGlyphs[g];
+}
+
+int TextAtlas::Draw(SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color) const
+{
+	if (!mTexture) return 0;
+
+	SDL_SetTextureColorMod(mTexture, color.r, color.g, color.b);
+	SDL_SetTextureAlphaMod(mTexture, color.a);
+
+	int copies = 0;
+	ForEachGlyph(text, x, y, [&](const SDL_Rect& glyph, const SDL_Rect& dest) {
+		SDL_RenderCopy(renderer, mTexture, &glyph, &dest);
+		copies++;
+	});
+	return copies;
+}
+
+void TextAtlas::Measure(const char* text, int& w, int& h) const
+{
+	w = 0;
+	h = 0;
+	if (!*text) return;
+
+	int lineWidth = 0;
+	h = mLineHeight;
+	for (const char* p = text; *p; p++) {
+		if (*p == '\n') {
+			lineWidth = 0;
+			h += mLineHeight;
+			continue;
+		}
+		lineWidth += Glyph(*p).w;
+		if (lineWidth > w) w = lineWidth;
+	}
+}
@@ -0,0 +1,80 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include "SDL/SDL.h"
+#include "SDL/SDL_ttf.h"
+
+// Texto a partir de um atlas: os caracteres imprimiveis (' ' a '~') da
+// fonte sao rasterizados uma vez numa textura, e cada string vira uma
+// copia por caractere dessa mesma textura, sem superficies, texturas
+// ou alocacoes por frame. Cada glifo e o TTF_RenderText_Solid do
+// caractere sozinho, entao com uma fonte monoespacada (VT323) o texto
+// sai igual ao da string inteira.
+class TextAtlas
+{
+public:
+	TextAtlas();
+	~TextAtlas();
+
+	TextAtlas(const TextAtlas&) = delete;
+	TextAtlas& operator=(const TextAtlas&) = delete;
+
+	// Rasteriza os glifos e cria a textura; false se nao conseguiu
+	bool Build(SDL_Renderer* renderer, TTF_Font* font);
+	// So rasteriza: devolve o atlas (RGBA8888, glifos brancos) para quem
+	// cria a textura por conta propria (o GlSceneRenderer); quem chama
+	// libera com SDL_FreeSurface. nullptr se nao conseguiu.
+	SDL_Surface* BuildSurface(TTF_Font* font);
+	void Destroy();
+
+	bool IsBuilt() const { return mTexture != nullptr; }
+	// altura de uma linha, em pixels
+	int LineHeight() const { return mLineHeight; }
+
+	// Desenha text com o canto de cima a esquerda em (x, y); '\n' muda de
+	// linha e caracteres fora do atlas viram '?'. Devolve quantos
+	// glifos foram copiados.
+	int Draw(SDL_Renderer* renderer, const char* text, int x, int y, SDL_Color color) const;
+	// Largura e altura que Draw ocuparia
+	void Measure(const char* text, int& w, int& h) const;
+
+	// Chama f(glyph, dest) para cada glifo visivel de text, com glyph o
+	// retangulo no atlas e dest onde ele fica na tela (mesmo layout do Draw)
+	template <typename F>
+	void ForEachGlyph(const char* text, int x, int y, F f) const
+	{
+		SDL_Rect dest = { x, y, 0, 0 };
+		for (const char* p = text; *p; p++) {
+			if (*p == '\n') {
+				dest.x = x;
+				dest.y += mLineHeight;
+				continue;
+			}
+
+			const SDL_Rect& glyph = Glyph(*p);
+			dest.w = glyph.w;
+			dest.h = glyph.h;
+			// espaco nao tem pixels para copiar
+			if (*p != ' ') f(glyph, dest);
+			dest.x += glyph.w;
+		}
+	}
+
+private:
+	static const int first_glyph = ' ';
+	static const int last_glyph = '~';
+	static const int glyph_count = last_glyph - first_glyph + 1;
+
+	const SDL_Rect& Glyph(char c) const;
+
+	SDL_Texture* mTexture;
+	// posicao de cada glifo no atlas (w e o avanco)
+	SDL_Rect mGlyphs[glyph_count];
+	int mLineHeight;
+};
@@ -0,0 +1,70 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <atomic>
+
+// Passa o valor mais novo de uma thread (que escreve) para outra (que
+// le) sem lock e sem nenhuma das duas esperar a outra. Sao tres copias:
+// a que o escritor preenche, a que o leitor esta usando e a do meio,
+// a ultima publicada. Publish e Update so trocam indices com a do meio
+// num std::atomic, entao o leitor sempre pega a mais nova e as
+// publicacoes que ele nao viu sao simplesmente descartadas.
+template <typename T>
+class TripleBuffer
+{
+public:
+	TripleBuffer()
+		:mWrite(0)
+		,mMiddle(1)
+		,mRead(2)
+	{
+	}
+
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	// Acesso direto as copias, so para prepara-las antes de as threads
+	// comecarem (Reserve, por exemplo)
+	T& Slot(int index) { return mSlots[index]; }
+
+	// Escritor: a copia a preencher antes de Publish
+	T& Write() { return mSlots[mWrite]; }
+	// Escritor: torna Write() a mais nova e passa a escrever na antiga
+	// do meio (que pode ter um valor velho; sobrescreva tudo)
+	void Publish()
+	{
+		int previous = mMiddle.exchange(mWrite | fresh_bit, std::memory_order_acq_rel);
+		mWrite = previous & index_mask;
+	}
+
+	// Leitor: pega a copia mais nova, se houve Publish desde a ultima
+	// vez; false se Read() continua a mesma
+	bool Update()
+	{
+		if (!(mMiddle.load(std::memory_order_relaxed) & fresh_bit)) return false;
+		int previous = mMiddle.exchange(mRead, std::memory_order_acq_rel);
+		mRead = previous & index_mask;
+		return true;
+	}
+	// Leitor: a copia pega no ultimo Update
+	const T& Read() const { return mSlots[mRead]; }
+
+private:
+	static const int index_mask = 3;
+	// a do meio foi publicada e o leitor ainda nao pegou
+	static const int fresh_bit = 4;
+
+	T mSlots[3];
+	// so o escritor mexe
+	int mWrite;
+	// indice da do meio, com fresh_bit
+	std::atomic<int> mMiddle;
+	// so o leitor mexe
+	int mRead;
+};
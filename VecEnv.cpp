@@ -0,0 +1,156 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "VecEnv.h"
+#include "WorkerPool.h"
+
+// velocidade que vira 1 na observacao
+const float obs_max_speed = 1000.0f;
+
+static float Clamp(float v, float lo, float hi)
+{
+	return v < lo ? lo : (v > hi ? hi : v);
+}
+
+VecEnv::VecEnv(int count, const SimConfig& simConfig, float simStep, int threads)
+	:config(simConfig)
+	,step(simStep)
+	,frameSkip(1)
+{
+	// cada ambiente roda numa thread so; o paralelismo e entre ambientes
+	config.threads = 1;
+	prototype.Initialize(config);
+
+	envs.resize(count > 0 ? count : 0);
+	episodes.assign(envs.size(), 0);
+	for (int i = 0; i < Size(); i++) ResetEnv(i);
+
+	if (threads > 1) pool.reset(new WorkerPool(threads));
+}
+
+VecEnv::~VecEnv()
+{
+}
+
+void VecEnv::ResetEnv(int i)
+{
+	// cada ambiente e cada partida com uma semente diferente; fora ela,
+	// a partida nova e o prototipo, copiado sem alocar (Initialize
+	// refaria raquetes, blocos, mapa e placar no meio do passo)
+	uint64_t seed = config.seed + i + episodes[i] * envs.size();
+	Simulation& sim = envs[i];
+	sim.CopyFrom(prototype);
+	sim.config.seed = seed;
+	sim.splitRandom.Seed(seed, STREAM_SPLIT);
+	episodes[i]++;
+}
+
+void VecEnv::Reset(float* observations)
+{
+	for (int i = 0; i < Size(); i++) {
+		ResetEnv(i);
+		Observe(envs[i], observations + (size_t)i * OBS_SIZE);
+	}
+}
+
+void VecEnv::Observe(const Simulation& sim, float* out)
+{
+	for (int k = 0; k < OBS_SIZE; k++) out[k] = 0.0f;
+
+	if (!sim.vPaddle.empty()) {
+		const Paddle& paddle = sim.vPaddle[0];
+		out[OBS_PADDLE_X] = (paddle.pos.x + paddle.width / 2.0f) / SCREEN_WIDTH;
+	}
+
+	// a bola mais baixa e a que ameaca sair
+	const BallStore& balls = sim.vBall;
+	if (!balls.Empty()) {
+		size_t lowest = 0;
+		for (size_t i = 1; i < balls.Size(); i++) {
+			if (balls.posY[i] > balls.posY[lowest]) lowest = i;
+		}
+		out[OBS_BALL_X] = (balls.posX[lowest] + thickness / 2.0f) / SCREEN_WIDTH;
+		out[OBS_BALL_Y] = (balls.posY[lowest] + thickness / 2.0f) / SCREEN_HEIGHT;
+		out[OBS_BALL_VX] = Clamp(balls.velX[lowest] / obs_max_speed, -1.0f, 1.0f);
+		out[OBS_BALL_VY] = Clamp(balls.velY[lowest] / obs_max_speed, -1.0f, 1.0f);
+	}
+
+	if (sim.config.maxBalls > 0) {
+		out[OBS_BALLS] = static_cast<float>(balls.Size()) / sim.config.maxBalls;
+	}
+	int blocks = sim.blocksAlive + sim.blocksDestroyed;
+	if (blocks > 0) {
+		out[OBS_BLOCKS] = static_cast<float>(sim.blocksAlive) / blocks;
+	}
+}
+
+void VecEnv::StepRange(int begin, int end, const int* actions,
+	float* observations, float* rewards, unsigned char* dones)
+{
+	SimInput input = {};
+	for (int i = begin; i < end; i++) {
+		Simulation& sim = envs[i];
+
+		int action = actions[i];
+		input.paddleDir[0] = action < 0 ? -1 : (action > 0 ? 1 : 0);
+
+		// as ticks do meio nao observam nem somam nada
+		int destroyed = sim.blocksDestroyed;
+		sim.StepRepeat(step, input, frameSkip);
+
+		float reward = static_cast<float>(sim.blocksDestroyed - destroyed);
+		bool lost = sim.IsOver();
+		if (lost) reward -= 1.0f;
+
+		bool done = lost || sim.blocksAlive == 0;
+		if (done) ResetEnv(i);
+
+		rewards[i] = reward;
+		dones[i] = done ? 1 : 0;
+		Observe(sim, observations + (size_t)i * OBS_SIZE);
+	}
+}
+
+void VecEnv::Step(const int* actions, float* observations, float* rewards, unsigned char* dones)
+{
+	int count = Size();
+	if (!pool) {
+		StepRange(0, count, actions, observations, rewards, dones);
+		return;
+	}
+
+	// faixas continuas de ambientes por worker; os ambientes sao
+	// independentes, entao o resultado nao depende das threads
+	int workers = pool->Size();
+	pool->Run([&](int w) {
+		StepRange(count * w / workers, count * (w + 1) / workers,
+			actions, observations, rewards, dones);
+	});
+}
+
+void VecEnv::RenderRange(int begin, int end, const RasterConfig& raster, unsigned char* pixels) const
+{
+	size_t frame = raster.FrameSize();
+	for (int i = begin; i < end; i++) {
+		Rasterize(envs[i], raster, pixels + i * frame);
+	}
+}
+
+void VecEnv::Render(const RasterConfig& raster, unsigned char* pixels) const
+{
+	int count = Size();
+	if (!pool) {
+		RenderRange(0, count, raster, pixels);
+		return;
+	}
+
+	int workers = pool->Size();
+	pool->Run([&](int w) {
+		RenderRange(count * w / workers, count * (w + 1) / workers, raster, pixels);
+	});
+}
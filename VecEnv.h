@@ -0,0 +1,93 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "Rasterizer.h"
+#include "Simulation.h"
+
+class WorkerPool;
+
+// Observacao de cada ambiente, em floats normalizados para [0, 1]
+// (velocidades em [-1, 1]); ver VecEnv::Observe
+enum ObservationField
+{
+	OBS_PADDLE_X,      // centro da raquete
+	OBS_BALL_X,        // centro da bola mais baixa
+	OBS_BALL_Y,
+	OBS_BALL_VX,
+	OBS_BALL_VY,
+	OBS_BALLS,         // bolas / maxBalls
+	OBS_BLOCKS,        // blocos restantes / blocos do mapa
+	OBS_SIZE
+};
+
+// Muitas partidas independentes avancando juntas, para treinar
+// controladores da raquete. Cada partida e uma Simulation (um vetor
+// delas, cada uma com os seus vetores de estado ja reservados); as acoes
+// e os resultados vem e vao em buffers do chamador. Toda partida comeca
+// como uma copia (Simulation::CopyFrom) de um prototipo montado uma vez,
+// entao nem o passo nem o recomeco de uma partida alocam depois que
+// cada ambiente ja recomecou uma vez.
+//
+// Cada passo e um tick de step segundos, ou frameSkip ticks com a mesma
+// acao (Simulation::StepRepeat). Acao por ambiente: -1, 0 ou +1
+// (direcao da raquete). Recompensa: blocos destruidos no passo, menos 1
+// quando a ultima bola sai por baixo. Ambiente que termina (sem bolas
+// ou sem blocos) recomeca sozinho com a proxima semente, e a observacao
+// devolvida ja e a da partida nova.
+class VecEnv
+{
+public:
+	// threads divide os ambientes entre threads (1 = so a que chama)
+	VecEnv(int count, const SimConfig& config = SimConfig(), float step = 1.0f / 120.0f, int threads = 1);
+	~VecEnv();
+
+	VecEnv(const VecEnv&) = delete;
+	VecEnv& operator=(const VecEnv&) = delete;
+
+	int Size() const { return static_cast<int>(envs.size()); }
+
+	// ticks por passo; a observacao e a recompensa sao do passo inteiro
+	void SetFrameSkip(int ticks) { frameSkip = ticks > 0 ? ticks : 1; }
+	int FrameSkip() const { return frameSkip; }
+
+	// Recomeca todas as partidas; observations tem Size() * OBS_SIZE floats
+	void Reset(float* observations);
+	// Avanca todas as partidas um tick com actions[Size()] e escreve
+	// observations[Size() * OBS_SIZE], rewards[Size()] e dones[Size()]
+	void Step(const int* actions, float* observations, float* rewards, unsigned char* dones);
+
+	// Desenha todas as partidas (Rasterize), um quadro depois do outro:
+	// pixels tem Size() * raster.FrameSize() bytes
+	void Render(const RasterConfig& raster, unsigned char* pixels) const;
+
+	Simulation& Env(int i) { return envs[i]; }
+	const Simulation& Env(int i) const { return envs[i]; }
+
+	// Observacao de uma simulacao (OBS_SIZE floats)
+	static void Observe(const Simulation& sim, float* out);
+
+private:
+	void ResetEnv(int i);
+	void StepRange(int begin, int end, const int* actions,
+		float* observations, float* rewards, unsigned char* dones);
+	void RenderRange(int begin, int end, const RasterConfig& raster, unsigned char* pixels) const;
+
+	// estado inicial de toda partida, so a semente muda
+	Simulation prototype;
+	std::vector<Simulation> envs;
+	// partidas ja jogadas por ambiente, para variar a semente
+	std::vector<uint64_t> episodes;
+	SimConfig config;
+	float step;
+	int frameSkip;
+	std::unique_ptr<WorkerPool> pool;
+};
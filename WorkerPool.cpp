@@ -0,0 +1,73 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(int workers)
+	:mJob(nullptr)
+	,mGeneration(0)
+	,mPending(0)
+	,mQuit(false)
+{
+	for (int i = 1; i < workers; i++)
+	{
+		mThreads.emplace_back(&WorkerPool::WorkerLoop, this, i);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mQuit = true;
+	}
+	mStart.notify_all();
+	for (auto& thread : mThreads) thread.join();
+}
+
+void WorkerPool::Run(const std::function<void(int)>& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mJob = &job;
+		mPending = static_cast<int>(mThreads.size());
+		mGeneration++;
+	}
+	mStart.notify_all();
+
+	job(0);
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mDone.wait(lock, [this] { return mPending == 0; });
+	mJob = nullptr;
+}
+
+void WorkerPool::WorkerLoop(int index)
+{
+	unsigned seen = 0;
+	for (;;)
+	{
+		const std::function<void(int)>* job;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mStart.wait(lock, [&] { return mQuit || mGeneration != seen; });
+			if (mQuit) return;
+			seen = mGeneration;
+			job = mJob;
+		}
+
+		(*job)(index);
+
+		bool last;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			last = --mPending == 0;
+		}
+		if (last) mDone.notify_one();
+	}
+}
@@ -0,0 +1,48 @@
+// ----------------------------------------------------------------
+// From Game Programming in C++ by Sanjay Madhav
+// Copyright (C) 2017 Sanjay Madhav. All rights reserved.
+//
+// Released under the BSD License
+// See LICENSE in root directory for full details.
+// ----------------------------------------------------------------
+
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Conjunto fixo de threads que executam a mesma tarefa em paralelo,
+// cada uma com seu indice. A thread que chama Run e o worker 0.
+class WorkerPool
+{
+public:
+	explicit WorkerPool(int workers);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	// numero de workers, contando a thread que chama Run
+	int Size() const { return static_cast<int>(mThreads.size()) + 1; }
+
+	// Executa job(0) .. job(Size() - 1) em paralelo e espera todos
+	void Run(const std::function<void(int)>& job);
+
+private:
+	void WorkerLoop(int index);
+
+	std::vector<std::thread> mThreads;
+
+	std::mutex mMutex;
+	std::condition_variable mStart;
+	std::condition_variable mDone;
+
+	const std::function<void(int)>* mJob;
+	// incrementado a cada Run, para os workers saberem que ha trabalho
+	unsigned mGeneration;
+	// workers que ainda nao terminaram o Run atual
+	int mPending;
+	bool mQuit;
+};